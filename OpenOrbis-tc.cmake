@@ -23,12 +23,14 @@ define_property(TARGET PROPERTY OO_FSELF_PATH BRIEF_DOCS "This property reports
 define_property(TARGET PROPERTY OO_PKG_ROOT BRIEF_DOCS "This property reports a path where pkg file will be created, should never be edited manually")
 define_property(TARGET PROPERTY OO_PKG_SDKVER BRIEF_DOCS "This property reports the SDK version used by package, should never be edited manually")
 define_property(TARGET PROPERTY OO_PKG_FINALIZED BRIEF_DOCS "This property reports whether package was finalized or not, should never be edited manually")
+define_property(TARGET PROPERTY OO_PKG_FILES BRIEF_DOCS "This property lists the package files as source|destination pairs, use OpenOrbisPackage_AddFile to add to it")
+define_property(TARGET PROPERTY OO_PKG_DEPENDS BRIEF_DOCS "This property lists the targets that create package files, use OpenOrbisPackage_AddFile to add to it")
 define_property(TARGET PROPERTY OO_PKG_TITLE BRIEF_DOCS "This property specifies TITLE for generated param.sfo file, can be edited between create and finalize blocks")
 define_property(TARGET PROPERTY OO_PKG_APPVER BRIEF_DOCS "This property specifies APPVER for generated param.sfo file, can be edited between create and finalize blocks")
 define_property(TARGET PROPERTY OO_PKG_CONTENTID BRIEF_DOCS "This property specifies CONTENT_ID for generated param.sfo file, can be edited between create and finalize blocks")
 define_property(TARGET PROPERTY OO_PKG_DOWNSIZE BRIEF_DOCS "This property specifies DOWNLOAD_DATA_SIZE for generated param.sfo file, can be edited between create and finalize blocks")
-define_property(TARGET PROPERTY OO_PKG_ATTRIBS1 BRIEF_DOCS "This property specifies ATTRIBUTE for generated param.sfo file, can be edited between create and finalize blocks")
-define_property(TARGET PROPERTY OO_PKG_ATTRIBS2 BRIEF_DOCS "This property specifies ATTRIBUTE2 for generated param.sfo file, can be edited between create and finalize blocks")
+define_property(TARGET PROPERTY OO_PKG_ATTRIBS1 BRIEF_DOCS "This property specifies ATTRIBUTE (a number or SfoAttributes bit names) for generated param.sfo file, can be edited between create and finalize blocks")
+define_property(TARGET PROPERTY OO_PKG_ATTRIBS2 BRIEF_DOCS "This property specifies ATTRIBUTE2 (a number or SfoAttributes bit names) for generated param.sfo file, can be edited between create and finalize blocks")
 
 set(CMAKE_SYSTEM_NAME FreeBSD CACHE STRING "" FORCE)
 set(CMAKE_C_COMPILER_TARGET "x86_64-pc-freebsd12-elf" CACHE STRING "" FORCE)
@@ -86,6 +88,7 @@ function(OpenOrbis_AddFSelfCommand TargetProject WorkDir FSelfName TargetSDKVer)
     ${CMAKE_COMMAND} -E env "OO_PS4_TOOLCHAIN=${OO_PS4_TOOLCHAIN}"
     ${OO_BINARIES_PATH}/create-fself -in "${WorkDir}/${FSelfName}.elf"
     --out "${WorkDir}/${FSelfName}.oelf" "--${OUT_TYPE}" "${OUT_ABS_PATH}" --paid 0x3800000000000011 --sdkver "${TargetSDKVer}" --fwversion "${OO_FWVER}"
+    BYPRODUCTS "${OUT_ABS_PATH}"
   )
 
   set_target_properties(${TargetProject} PROPERTIES OO_FSELF_PATH "${OUT_ABS_PATH}")
@@ -105,81 +108,61 @@ function(OpenOrbisPackage_PostProject pkg_title_id pkg_fw_version_hex)
   )
 
   # install
-  install(FILES ${path_bin}/eboot.bin
-    DESTINATION "${install_dir}"
-  )
+  OpenOrbisPackage_AddFile(${pkg_title_id} "${path_bin}/eboot.bin" "eboot.bin" ${pkg_title_id})
 
   install(DIRECTORY
     ${CMAKE_SOURCE_DIR}/app_data/
     DESTINATION "${install_dir}"
   )
+  # Only the icon goes into the pkg, the install above already copies it.
+  set_property(TARGET ${pkg_title_id} APPEND PROPERTY OO_PKG_FILES "${CMAKE_SOURCE_DIR}/app_data/sce_sys/icon0.png|sce_sys/icon0.png")
 
-  install(DIRECTORY
-    ${CMAKE_CURRENT_SOURCE_DIR}/assets
-    DESTINATION "${install_dir}"
-    OPTIONAL
-  )
+  file(GLOB_RECURSE asset_files CONFIGURE_DEPENDS RELATIVE ${CMAKE_CURRENT_SOURCE_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/assets/*)
+  foreach(asset_file ${asset_files})
+    OpenOrbisPackage_AddFile(${pkg_title_id} "${CMAKE_CURRENT_SOURCE_DIR}/${asset_file}" "${asset_file}")
+  endforeach()
 
   get_property(list GLOBAL PROPERTY OO_PRJ_LIST)
   list(APPEND list "${pkg_title_id}")
   set_property(GLOBAL PROPERTY OO_PRJ_LIST "${list}")
 endfunction()
 
-function(OpenOrbisPackage_FinalizeProject pkg_title_id)
+# Installs a file to <pkg root>/<dest> and packs it into the pkg at the same path. producer_target is the
+# target that creates the file, if any, the pkg is rebuilt after it.
+function(OpenOrbisPackage_AddFile pkg_title_id src dest)
   get_target_property(pkg_finalized ${pkg_title_id} OO_PKG_FINALIZED)
 
   if(pkg_finalized)
-    message(FATAL_ERROR "Target ${pkg_title_id} is already finalized!")
+    message(FATAL_ERROR "Target ${pkg_title_id} is already finalized, can't add ${dest}")
   endif()
 
-  set_target_properties(${pkg_title_id} PROPERTIES OO_PKG_FINALIZED TRUE)
+  get_target_property(pkg_root ${pkg_title_id} OO_PKG_ROOT)
+  get_filename_component(dest_dir "${dest}" DIRECTORY)
+  get_filename_component(dest_name "${dest}" NAME)
+  install(FILES "${src}"
+    DESTINATION "${pkg_root}/${dest_dir}"
+    RENAME "${dest_name}"
+  )
 
-  set(BASE_SCRIPT [=[
-    set(ENV{OO_PS4_TOOLCHAIN} "${orbis_path}")
-
-    # Create param.sfo
-    if(CMAKE_HOST_WIN32)
-      set(PatchParamSfoCommand "${prj_root}/patch_param.bat")
-      set(PackageCommand "${prj_root}/package.bat")
-    elseif(CMAKE_HOST_LINUX)
-      set(PatchParamSfoCommand "${prj_root}/patch_param.sh")
-      set(PackageCommand "${prj_root}/package.sh")
-    else()
-      message(FATAL_ERROR "Unsupported OS, can't create param.sfo")
-    endif()
+  set_property(TARGET ${pkg_title_id} APPEND PROPERTY OO_PKG_FILES "${src}|${dest}")
 
-    message(STATUS "Creating param.sfo file")
-    execute_process(
-      COMMAND "${PatchParamSfoCommand}"
-      "${pkg_title}"
-      "${pkg_appver}"
-      "${pkg_title_id}"
-      "${pkg_content_id}"
-      "${pkg_downsize}"
-      "${pkg_fw_version_hex}"
-      "${pkg_attribs1}"
-      "${pkg_attribs2}"
-      "${ShouldBuildArg}"
-      WORKING_DIRECTORY "${pkg_root}/sce_sys"
-    )
+  if(ARGC GREATER 3)
+    set_property(TARGET ${pkg_title_id} APPEND PROPERTY OO_PKG_DEPENDS ${ARGV3})
+  endif()
+endfunction()
 
-    if(NOT OO_PS4_NOPKG)
-      message(STATUS "Creating GP4 file")
+function(OpenOrbisPackage_FinalizeProject pkg_title_id)
+  get_target_property(pkg_finalized ${pkg_title_id} OO_PKG_FINALIZED)
 
-      # create pkg
-      execute_process(
-        COMMAND "${PackageCommand}" "${pkg_content_id}"
-        WORKING_DIRECTORY "${pkg_root}"
-      )
-    endif()
-  ]=])
+  if(pkg_finalized)
+    message(FATAL_ERROR "Target ${pkg_title_id} is already finalized!")
+  endif()
 
-  if(OO_PS4_NOPKG)
-    set(ShouldBuildArg "nopkg")
-  else()
-    set(ShouldBuildArg "pkg")
+  if(NOT INTEST_SFO_TOOL)
+    message(FATAL_ERROR "INTEST_SFO_TOOL is not set, build through the top level CMakeLists.txt or point it to intest_sfo from ./tools")
   endif()
 
+  get_target_property(path_bin ${pkg_title_id} RUNTIME_OUTPUT_DIRECTORY)
   get_target_property(pkg_root ${pkg_title_id} OO_PKG_ROOT)
   get_target_property(pkg_fw_version_hex ${pkg_title_id} OO_PKG_SDKVER)
   get_target_property(pkg_title ${pkg_title_id} OO_PKG_TITLE)
@@ -188,23 +171,79 @@ function(OpenOrbisPackage_FinalizeProject pkg_title_id)
   get_target_property(pkg_attribs1 ${pkg_title_id} OO_PKG_ATTRIBS1)
   get_target_property(pkg_attribs2 ${pkg_title_id} OO_PKG_ATTRIBS2)
   get_target_property(pkg_downsize ${pkg_title_id} OO_PKG_DOWNSIZE)
-  string(CONFIGURE [=[
-    set(orbis_path "${OO_PS4_TOOLCHAIN}")
-    set(prj_root "${INTEST_SOURCE_ROOT}")
-    set(pkg_root "${pkg_root}")
-    set(pkg_title "${pkg_title}")
-    set(pkg_title_id "${pkg_title_id}")
-    set(pkg_content_id "${pkg_content_id}")
-    set(pkg_fw_version_hex "${pkg_fw_version_hex}")
-    set(pkg_appver "${pkg_appver}")
-    set(pkg_attribs1 "${pkg_attribs1}")
-    set(pkg_attribs2 "${pkg_attribs2}")
-    set(pkg_downsize "${pkg_downsize}")
-    set(ShouldBuildArg "${ShouldBuildArg}")
-    ${BASE_SCRIPT}
-  ]=] install_code)
-
-  install(CODE "${install_code}")
+
+  # Create param.sfo at build time with intest_sfo from ./tools/make_sfo, the superbuild builds it first.
+  # The params file is only rewritten when a property changed, so param.sfo is only rebuilt then.
+  # Attributes can be CMake lists of SfoAttributes bit names and numbers.
+  string(REPLACE ";" "," pkg_attribs1 "${pkg_attribs1}")
+  string(REPLACE ";" "," pkg_attribs2 "${pkg_attribs2}")
+  file(CONFIGURE OUTPUT "${path_bin}/param_sfo.txt" CONTENT [=[
+APP_TYPE=1
+APP_VER=${pkg_appver}
+ATTRIBUTE=${pkg_attribs1}
+ATTRIBUTE2=${pkg_attribs2}
+CATEGORY=gd
+CONTENT_ID=${pkg_content_id}
+DOWNLOAD_DATA_SIZE=${pkg_downsize}
+SYSTEM_VER=${pkg_fw_version_hex}
+TITLE=${pkg_title}
+TITLE_ID=${pkg_title_id}
+VERSION=${pkg_appver}
+]=])
+
+  add_custom_command(OUTPUT "${path_bin}/param.sfo"
+    COMMAND "${INTEST_SFO_TOOL}" "${path_bin}/param_sfo.txt" "${path_bin}/param.sfo"
+    DEPENDS "${path_bin}/param_sfo.txt" "${INTEST_SFO_TOOL}"
+    COMMENT "Creating param.sfo for ${pkg_title_id}"
+    VERBATIM
+  )
+  add_custom_target(${pkg_title_id}_sfo ALL DEPENDS "${path_bin}/param.sfo")
+  OpenOrbisPackage_AddFile(${pkg_title_id} "${path_bin}/param.sfo" "sce_sys/param.sfo" ${pkg_title_id}_sfo)
+
+  set_target_properties(${pkg_title_id} PROPERTIES OO_PKG_FINALIZED TRUE)
+
+  get_target_property(pkg_depends ${pkg_title_id} OO_PKG_DEPENDS)
+
+  if(OO_PS4_NOPKG)
+    # Without a pkg, the package is made of the targets that create its files.
+    set_property(GLOBAL APPEND PROPERTY OO_PKG_TARGETS ${pkg_depends})
+    return()
+  endif()
+
+  # Create the pkg at build time from the files added with OpenOrbisPackage_AddFile. The file list is
+  # only rewritten when it changed, package.cmake skips create-gp4 and PkgTool when the content of the
+  # files is the same as for the last pkg, so a rebuilt but identical eboot.bin doesn't repackage.
+  get_target_property(pkg_files ${pkg_title_id} OO_PKG_FILES)
+  set(pkg_sources)
+
+  foreach(pkg_file ${pkg_files})
+    string(REGEX REPLACE "\\|.*$" "" pkg_source "${pkg_file}")
+    list(APPEND pkg_sources "${pkg_source}")
+  endforeach()
+
+  string(REPLACE ";" "\n" pkg_manifest "${pkg_files}")
+  file(CONFIGURE OUTPUT "${path_bin}/pkg_files.txt" CONTENT "${pkg_manifest}\n")
+
+  set(pkg_stage "${path_bin}/pkg")
+  set(pkg_output "${pkg_stage}/${pkg_content_id}.pkg")
+  add_custom_command(OUTPUT "${pkg_output}"
+    COMMAND ${CMAKE_COMMAND}
+    "-DOO_PS4_TOOLCHAIN=${OO_PS4_TOOLCHAIN}"
+    "-DOO_BINARIES_PATH=${OO_BINARIES_PATH}"
+    "-DPKG_CONTENT_ID=${pkg_content_id}"
+    "-DPKG_FILES=${path_bin}/pkg_files.txt"
+    "-DPKG_STAGE=${pkg_stage}"
+    -P "${INTEST_SOURCE_ROOT}/package.cmake"
+    DEPENDS "${path_bin}/pkg_files.txt" "${INTEST_SOURCE_ROOT}/package.cmake" ${pkg_sources} ${pkg_depends}
+    COMMENT "Creating pkg for ${pkg_title_id}"
+    VERBATIM
+  )
+  add_custom_target(${pkg_title_id}_pkg ALL DEPENDS "${pkg_output}")
+  set_property(GLOBAL APPEND PROPERTY OO_PKG_TARGETS ${pkg_title_id}_pkg)
+
+  install(FILES "${pkg_output}"
+    DESTINATION "${pkg_root}"
+  )
 endfunction()
 
 function(OpenOrbisPackage_Validate)
@@ -222,4 +261,10 @@ function(OpenOrbisPackage_Validate)
       message(FATAL_ERROR "Missing finalize call for ${Target}")
     endif()
   endforeach()
+
+  # Builds every package without installing, the packages are independent targets and run in parallel with -j.
+  get_property(pkg_targets GLOBAL PROPERTY OO_PKG_TARGETS)
+  add_custom_target(packages)
+  list(REMOVE_DUPLICATES pkg_targets)
+  add_dependencies(packages ${pkg_targets})
 endfunction()
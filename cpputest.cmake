@@ -0,0 +1,66 @@
+# Where CppUTest comes from, included by the superbuild and ./tests.
+#
+# INTEST_CPPUTEST - CppUTest source folder or archive (.zip, .tar.gz, ...), builds offline and always with the same CppUTest
+# INTEST_CPPUTEST_TAG - git revision fetched from GitHub when INTEST_CPPUTEST is not set, release v4.0 by default
+# INTEST_CPPUTEST_PREFIX - cache folder for CppUTest builds made with OpenOrbis-tc.cmake. Every tag or source gets its own
+#                          subfolder, the superbuild builds and installs it there when it isn't yet, ./tests then links it
+#                          instead of building CppUTest again.
+#
+# Result:
+# INTEST_CPPUTEST_SOURCE - the source arguments for FetchContent_Declare and ExternalProject_Add
+# INTEST_CPPUTEST_OPTIONS - CppUTest cache settings as NAME=value
+# INTEST_CPPUTEST_INSTALL_DIR - the subfolder of INTEST_CPPUTEST_PREFIX for this tag or source
+# INTEST_CPPUTEST_INSTALLED - TRUE when INTEST_CPPUTEST_INSTALL_DIR already holds CppUTest
+
+if(INTEST_CPPUTEST)
+  if(IS_DIRECTORY "${INTEST_CPPUTEST}")
+    set(INTEST_CPPUTEST_SOURCE SOURCE_DIR "${INTEST_CPPUTEST}")
+    string(MD5 cpputest_key "${INTEST_CPPUTEST}")
+  elseif(EXISTS "${INTEST_CPPUTEST}")
+    set(INTEST_CPPUTEST_SOURCE URL "${INTEST_CPPUTEST}")
+    file(MD5 "${INTEST_CPPUTEST}" cpputest_key)
+  else()
+    message(FATAL_ERROR "INTEST_CPPUTEST is set to ${INTEST_CPPUTEST}, which doesn't exist")
+  endif()
+else()
+  if(NOT INTEST_CPPUTEST_TAG)
+    set(INTEST_CPPUTEST_TAG "v4.0")
+  endif()
+
+  string(MAKE_C_IDENTIFIER "${INTEST_CPPUTEST_TAG}" cpputest_key)
+
+  set(INTEST_CPPUTEST_SOURCE
+    GIT_REPOSITORY https://github.com/cpputest/cpputest.git
+    GIT_TAG ${INTEST_CPPUTEST_TAG}
+  )
+endif()
+
+# The CPPUTEST_ names are used after v4.0, the short ones up to v4.0. v4.0 still asks for CMake 3.1.
+set(INTEST_CPPUTEST_OPTIONS
+  CPPUTEST_EXTENSIONS=ON
+  CPPUTEST_STD_C_LIB_DISABLED=OFF
+  CPPUTEST_STD_CPP_LIB_DISABLED=OFF
+  CPPUTEST_BUILD_TESTING=OFF
+  CPPUTEST_EXAMPLES=OFF
+  EXTENSIONS=ON
+  STD_C=ON
+  STD_CPP=ON
+  TESTS=OFF
+  EXAMPLES=OFF
+  CMAKE_POLICY_VERSION_MINIMUM=3.5
+)
+
+set(INTEST_CPPUTEST_INSTALL_DIR "")
+set(INTEST_CPPUTEST_INSTALLED FALSE)
+
+if(INTEST_CPPUTEST_PREFIX)
+  set(INTEST_CPPUTEST_INSTALL_DIR "${INTEST_CPPUTEST_PREFIX}/${cpputest_key}")
+  file(GLOB cpputest_config
+    "${INTEST_CPPUTEST_INSTALL_DIR}/lib*/CppUTest/cmake/CppUTestConfig.cmake"
+    "${INTEST_CPPUTEST_INSTALL_DIR}/lib*/cmake/CppUTest/CppUTestConfig.cmake"
+  )
+
+  if(cpputest_config)
+    set(INTEST_CPPUTEST_INSTALLED TRUE)
+  endif()
+endif()
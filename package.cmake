@@ -0,0 +1,88 @@
+# Creates the pkg of one package, run by the command OpenOrbisPackage_FinalizeProject adds:
+#
+# cmake -DOO_PS4_TOOLCHAIN=... -DOO_BINARIES_PATH=... -DPKG_CONTENT_ID=... -DPKG_FILES=<file list> -DPKG_STAGE=<dir> -P package.cmake
+#
+# PKG_FILES has one source|destination line per file. The files are copied to PKG_STAGE/root in the package
+# layout, create-gp4 and PkgTool then run there and write PKG_STAGE/<content id>.pkg. The content of all files
+# is hashed, when it matches the hash of the last pkg the tools don't run again.
+
+cmake_minimum_required(VERSION 3.24)
+
+foreach(var OO_PS4_TOOLCHAIN OO_BINARIES_PATH PKG_CONTENT_ID PKG_FILES PKG_STAGE)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "package.cmake: ${var} is not set")
+  endif()
+endforeach()
+
+set(stage_root "${PKG_STAGE}/root")
+set(pkg_output "${PKG_STAGE}/${PKG_CONTENT_ID}.pkg")
+set(pkg_stamp "${PKG_STAGE}/pkg_inputs.sha256")
+
+file(STRINGS "${PKG_FILES}" pkg_files)
+set(pkg_dests)
+set(pkg_hashes "${PKG_CONTENT_ID}\n")
+
+foreach(pkg_file ${pkg_files})
+  string(REGEX REPLACE "\\|.*$" "" source "${pkg_file}")
+  string(REGEX REPLACE "^.*\\|" "" dest "${pkg_file}")
+  get_filename_component(dest_dir "${stage_root}/${dest}" DIRECTORY)
+  file(MAKE_DIRECTORY "${dest_dir}")
+  file(COPY_FILE "${source}" "${stage_root}/${dest}" ONLY_IF_DIFFERENT)
+  file(SHA256 "${stage_root}/${dest}" hash)
+  list(APPEND pkg_dests "${dest}")
+  string(APPEND pkg_hashes "${hash} ${dest}\n")
+endforeach()
+
+# Files that were removed from the package since the last run.
+file(GLOB_RECURSE staged_files RELATIVE "${stage_root}" "${stage_root}/*")
+
+foreach(staged_file ${staged_files})
+  if(NOT staged_file IN_LIST pkg_dests AND NOT staged_file STREQUAL "pkg.gp4")
+    file(REMOVE "${stage_root}/${staged_file}")
+  endif()
+endforeach()
+
+string(SHA256 pkg_inputs "${pkg_hashes}")
+
+if(EXISTS "${pkg_output}" AND EXISTS "${pkg_stamp}")
+  file(READ "${pkg_stamp}" last_inputs)
+
+  if(last_inputs STREQUAL pkg_inputs)
+    message(STATUS "${PKG_CONTENT_ID}.pkg is up to date")
+    # The build tool compares timestamps, the inputs are newer than the pkg.
+    file(TOUCH_NOCREATE "${pkg_output}")
+    return()
+  endif()
+endif()
+
+if(CMAKE_HOST_WIN32)
+  set(tool_suffix ".exe")
+else()
+  set(tool_suffix "")
+endif()
+
+set(ENV{OO_PS4_TOOLCHAIN} "${OO_PS4_TOOLCHAIN}")
+file(REMOVE "${pkg_output}" "${pkg_stamp}")
+list(JOIN pkg_dests " " gp4_files)
+
+execute_process(
+  COMMAND "${OO_BINARIES_PATH}/create-gp4${tool_suffix}" -out pkg.gp4 "--content-id=${PKG_CONTENT_ID}" --files "${gp4_files}"
+  WORKING_DIRECTORY "${stage_root}"
+  RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "create-gp4 failed for ${PKG_CONTENT_ID}: ${result}")
+endif()
+
+execute_process(
+  COMMAND "${OO_BINARIES_PATH}/PkgTool.Core${tool_suffix}" pkg_build pkg.gp4 "${PKG_STAGE}"
+  WORKING_DIRECTORY "${stage_root}"
+  RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0 OR NOT EXISTS "${pkg_output}")
+  message(FATAL_ERROR "PkgTool failed for ${PKG_CONTENT_ID}: ${result}")
+endif()
+
+file(WRITE "${pkg_stamp}" "${pkg_inputs}")
@@ -0,0 +1,171 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+TEST_GROUP (BandwidthBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+// Keeps the compiler from dropping the read loops.
+static volatile uint64_t bandwidth_bench_sink = 0;
+
+// Bytes moved per measurement, every measurement loops over its region until it has moved this much.
+static const uint64_t bandwidth_bench_bytes = 0x20000000;
+
+static double bandwidth_bench_read(uint64_t addr, uint64_t size) {
+  const uint64_t* data   = reinterpret_cast<const uint64_t*>(addr);
+  const uint64_t  count  = size / sizeof(uint64_t);
+  const uint64_t  passes = bandwidth_bench_bytes / size;
+  uint64_t        sum    = 0;
+  uint64_t        start  = bench_ticks();
+  for (uint64_t pass = 0; pass < passes; ++pass) {
+    for (uint64_t i = 0; i < count; i += 4) {
+      sum += data[i] + data[i + 1] + data[i + 2] + data[i + 3];
+    }
+  }
+  double total_ns      = bench_ticks_to_ns(bench_ticks() - start);
+  bandwidth_bench_sink = sum;
+  return double(size * passes) / total_ns;
+}
+
+static double bandwidth_bench_write(uint64_t addr, uint64_t size) {
+  const uint64_t passes = bandwidth_bench_bytes / size;
+  uint64_t       start  = bench_ticks();
+  for (uint64_t pass = 0; pass < passes; ++pass) {
+    memset(reinterpret_cast<void*>(addr), int(pass), size);
+  }
+  return double(size * passes) / bench_ticks_to_ns(bench_ticks() - start);
+}
+
+static double bandwidth_bench_copy(uint64_t dst, uint64_t src, uint64_t size) {
+  const uint64_t passes = bandwidth_bench_bytes / size;
+  uint64_t       start  = bench_ticks();
+  for (uint64_t pass = 0; pass < passes; ++pass) {
+    memcpy(reinterpret_cast<void*>(dst), reinterpret_cast<const void*>(src), size);
+  }
+  return double(size * passes) / bench_ticks_to_ns(bench_ticks() - start);
+}
+
+// Follows the pointer chain built by bandwidth_bench_build_chain, every load depends on the previous one.
+static double bandwidth_bench_chase(uint64_t addr, uint64_t steps) {
+  uint64_t node  = addr;
+  uint64_t start = bench_ticks();
+  for (uint64_t i = 0; i < steps; ++i) {
+    node = *reinterpret_cast<const volatile uint64_t*>(node);
+  }
+  double total_ns      = bench_ticks_to_ns(bench_ticks() - start);
+  bandwidth_bench_sink = node;
+  return total_ns / double(steps);
+}
+
+// Links one node per cache line into a single random cycle (Sattolo's algorithm), defeating the hardware prefetcher.
+static void bandwidth_bench_build_chain(uint64_t addr, uint64_t size) {
+  const uint64_t        stride     = 64;
+  const uint64_t        node_count = size / stride;
+  std::vector<uint32_t> order(node_count);
+  std::mt19937          rng(0xC4A5E);
+  for (uint64_t i = 0; i < node_count; ++i) {
+    order[i] = uint32_t(i);
+  }
+  for (uint64_t i = node_count - 1; i > 0; --i) {
+    uint64_t j = std::uniform_int_distribution<uint64_t>(0, i - 1)(rng);
+    std::swap(order[i], order[j]);
+  }
+  for (uint64_t i = 0; i < node_count; ++i) {
+    uint64_t next                                          = order[(i + 1) % node_count];
+    *reinterpret_cast<uint64_t*>(addr + order[i] * stride) = addr + next * stride;
+  }
+}
+
+TEST(BandwidthBench, DirectMemoryTypeBench) {
+  // Maps the same direct memory under every memory type and a CPU-only and CPU+GPU protection, switching between
+  // them with sceKernelMtypeprotect so the physical pages and their contents stay identical across all rows.
+  // The first half of the mapping is used for sequential read/write/copy, the second half holds the pointer chain.
+  struct BandwidthRow {
+    int32_t mtype;
+    int32_t prot;
+    double  read_gbps;
+    double  write_gbps;
+    double  copy_gbps;
+    double  chase_ns;
+  };
+
+  const uint64_t size        = 0x4000000;
+  const uint64_t seq_size    = size / 2;
+  const uint64_t chase_steps = 0x100000;
+  BandwidthRow   rows[22]    = {};
+  int32_t        row_count   = 0;
+
+  int64_t phys_addr = 0;
+  int32_t result    = sceKernelAllocateMainDirectMemory(size, 0x200000, 0, &phys_addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  uint64_t addr = 0;
+  result        = sceKernelMapDirectMemory(&addr, size, 0x33, 0, phys_addr, 0x200000);
+  UNSIGNED_INT_EQUALS(0, result);
+  memset(reinterpret_cast<void*>(addr), 0, seq_size);
+  bandwidth_bench_build_chain(addr + seq_size, size - seq_size);
+
+  for (int32_t mtype = 0; mtype <= 10; ++mtype) {
+    // Memory type 10 refuses CPU writes, only the read side can be measured there.
+    bool          writable = mtype != 10;
+    const int32_t prots[]  = {writable ? 0x3 : 0x1, writable ? 0x33 : 0x11};
+    for (int32_t prot: prots) {
+      result = sceKernelMtypeprotect(addr, size, mtype, prot);
+      UNSIGNED_INT_EQUALS(0, result);
+
+      BandwidthRow& row = rows[row_count++];
+      row.mtype         = mtype;
+      row.prot          = prot;
+      row.read_gbps     = bandwidth_bench_read(addr, seq_size);
+      row.write_gbps    = writable ? bandwidth_bench_write(addr, seq_size) : 0.0;
+      row.copy_gbps     = writable ? bandwidth_bench_copy(addr, addr + seq_size / 2, seq_size / 2) : 0.0;
+      row.chase_ns      = bandwidth_bench_chase(addr + seq_size, chase_steps);
+      intest_printf("[bench] BandwidthBench/mtype%d/prot0x%x read_gbps=%.3f write_gbps=%.3f copy_gbps=%.3f chase_ns=%.1f\n", mtype, prot, row.read_gbps,
+                    row.write_gbps, row.copy_gbps, row.chase_ns);
+    }
+  }
+
+  result = sceKernelCheckedReleaseDirectMemory(phys_addr, size);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  intest_printf("\n%5s | %6s | %9s | %10s | %9s | %8s\n", "mtype", "prot", "read_GB/s", "write_GB/s", "copy_GB/s", "chase_ns");
+  for (int32_t i = 0; i < row_count; ++i) {
+    intest_printf("%5d | 0x%04x | %9.3f | %10.3f | %9.3f | %8.1f\n", rows[i].mtype, rows[i].prot, rows[i].read_gbps, rows[i].write_gbps, rows[i].copy_gbps,
+                  rows[i].chase_ns);
+  }
+  intest_printf("\n");
+}
+
+TEST(BandwidthBench, WbGarlicBench) {
+  // The writable WB garlic path from DeviceFileTest: memory type 10 mapped through /dev/dmem1 with flag 0x800000.
+  // CPU access stays read-only here, so only sequential reads are measured.
+  const uint64_t size     = 0x2000000;
+  int32_t        dmem1_fd = sceKernelOpen("/dev/dmem1", 0x2, 0777);
+  CHECK(dmem1_fd > 0);
+
+  int64_t phys_addr = 0;
+  int32_t result    = sceKernelAllocateMainDirectMemory(size, 0x200000, 10, &phys_addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  // Flags Shared (0x1) | WritableWbGarlic (0x800000), prot CPU read.
+  uint64_t addr = 0;
+  result        = sceKernelMmap(addr, size, 0x1, 0x800001, dmem1_fd, phys_addr, &addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  double read_gbps = bandwidth_bench_read(addr, size);
+  intest_printf("[bench] BandwidthBench/wb_garlic/prot0x1 read_gbps=%.3f\n", read_gbps);
+
+  result = sceKernelMunmap(addr, size);
+  UNSIGNED_INT_EQUALS(0, result);
+  result = sceKernelCheckedReleaseDirectMemory(phys_addr, size);
+  UNSIGNED_INT_EQUALS(0, result);
+  result = sceKernelClose(dmem1_fd);
+  UNSIGNED_INT_EQUALS(0, result);
+}
@@ -0,0 +1,142 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+
+// Scratch file backing the file mappings, removed again after every test.
+static const char* coalesce_bench_path = "/download0/coalesce_bench.bin";
+
+TEST_GROUP (CoalesceBench) {
+  void setup() {}
+
+  void teardown() { sceKernelUnlink(coalesce_bench_path); }
+};
+
+enum class CoalesceKind { Anon, File, Direct };
+
+struct CoalescePhase {
+  const char*  name;
+  CoalesceKind kind;
+  int32_t      flags;
+  int32_t      prot;
+  bool         mergeable;
+};
+
+// Every mapping goes through this one function so the calling address stays the same,
+// firmwares below 5.50 refuse to merge areas created from different call sites.
+static int32_t __attribute__((optnone, noinline)) coalesce_map(const CoalescePhase& phase, uint64_t* addr, uint64_t size, int32_t fd, int64_t offset) {
+  if (phase.kind == CoalesceKind::Direct) {
+    return sceKernelMapDirectMemory(addr, size, phase.prot, phase.flags, offset, 0);
+  }
+  return sceKernelMmap(*addr, size, phase.prot, phase.flags, fd, offset, addr);
+}
+
+// Counts the VMAs that start inside [start, end).
+static uint64_t coalesce_count_vmas(uint64_t start, uint64_t end) {
+  uint64_t count = 0;
+  uint64_t addr  = start;
+  while (addr < end) {
+    OrbisKernelVirtualQueryInfo info = {};
+    if (sceKernelVirtualQuery(addr, 1, &info, sizeof(info)) != 0 || info.start >= end) break;
+    addr = info.end;
+    ++count;
+  }
+  return count;
+}
+
+TEST(CoalesceBench, CoalescingPressureBench) {
+  // Maps thousands of adjacent pages left to right with the flag combinations CoalescingTest checks,
+  // then records how many VMAs the kernel ended up with and what each map, mprotect and munmap call cost.
+  // A kernel that merges properly keeps mergeable phases at a single VMA, non-mergeable phases end up with one VMA per page.
+  const uint64_t page_size   = 0x4000;
+  const uint64_t page_count  = 2048;
+  const uint64_t window_size = page_size * page_count;
+  const uint64_t base_addr   = 0x7000000000;
+
+  // Flags: Shared (0x1) | Fixed (0x10) | Void (0x100) | Anon (0x1000) | NoCoalesce (0x400000)
+  const CoalescePhase phases[] = {
+      {"reserved_shared", CoalesceKind::Anon, 0x111, 0, true},
+      {"reserved_shared_nocoalesce", CoalesceKind::Anon, 0x400111, 0, false},
+      {"flexible_anon", CoalesceKind::Anon, 0x1010, 3, false},
+      {"flexible_anon_nocoalesce", CoalesceKind::Anon, 0x401010, 3, false},
+      {"file_shared", CoalesceKind::File, 0x11, 3, true},
+      {"file_private", CoalesceKind::File, 0x10, 3, false},
+      {"direct", CoalesceKind::Direct, 0x10, 3, false},
+      {"direct_nocoalesce", CoalesceKind::Direct, 0x400010, 3, false},
+  };
+
+  // Backing file for the file phases, one page of file per mapped page.
+  int32_t fd = sceKernelOpen(coalesce_bench_path, 0x602, 0666);
+  CHECK(fd > 0);
+  int32_t result = sceKernelFtruncate(fd, window_size);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  // Backing direct memory for the direct phases, physically contiguous so neighbouring pages have sequential offsets.
+  int64_t phys_addr = 0;
+  result            = sceKernelAllocateMainDirectMemory(window_size, 0x200000, 0, &phys_addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  for (const CoalescePhase& phase: phases) {
+    LatencyStats map_stats(page_count);
+    LatencyStats protect_stats(page_count);
+    LatencyStats unmap_stats(page_count);
+
+    for (uint64_t i = 0; i < page_count; ++i) {
+      uint64_t addr   = base_addr + i * page_size;
+      int64_t  offset = 0;
+      if (phase.kind == CoalesceKind::File) offset = i * page_size;
+      if (phase.kind == CoalesceKind::Direct) offset = phys_addr + i * page_size;
+
+      uint64_t start = bench_ticks();
+      result         = coalesce_map(phase, &addr, page_size, phase.kind == CoalesceKind::File ? fd : -1, offset);
+      map_stats.add(bench_ticks() - start);
+      UNSIGNED_INT_EQUALS(0, result);
+    }
+    uint64_t vmas_after_map = coalesce_count_vmas(base_addr, base_addr + window_size);
+
+    // Reserved areas have no protection to change.
+    uint64_t vmas_after_protect = vmas_after_map;
+    if (phase.prot != 0) {
+      for (uint64_t i = 0; i < page_count; ++i) {
+        uint64_t start = bench_ticks();
+        result         = sceKernelMprotect(base_addr + i * page_size, page_size, 1);
+        protect_stats.add(bench_ticks() - start);
+        UNSIGNED_INT_EQUALS(0, result);
+      }
+      vmas_after_protect = coalesce_count_vmas(base_addr, base_addr + window_size);
+    }
+
+    // Unmap page by page from the front, this splits merged areas on every call.
+    for (uint64_t i = 0; i < page_count; ++i) {
+      uint64_t start = bench_ticks();
+      result         = sceKernelMunmap(base_addr + i * page_size, page_size);
+      unmap_stats.add(bench_ticks() - start);
+      UNSIGNED_INT_EQUALS(0, result);
+    }
+    LONGS_EQUAL(0, coalesce_count_vmas(base_addr, base_addr + window_size));
+
+    char name[96];
+    snprintf(name, sizeof(name), "%s/map", phase.name);
+    map_stats.report("CoalesceBench", name);
+    if (phase.prot != 0) {
+      snprintf(name, sizeof(name), "%s/mprotect", phase.name);
+      protect_stats.report("CoalesceBench", name);
+    }
+    snprintf(name, sizeof(name), "%s/munmap", phase.name);
+    unmap_stats.report("CoalesceBench", name);
+    intest_printf("[bench] CoalesceBench/%s/vmas pages=%llu after_map=%llu after_mprotect=%llu mergeable=%d\n", phase.name, (unsigned long long)page_count,
+                  (unsigned long long)vmas_after_map, (unsigned long long)vmas_after_protect, phase.mergeable ? 1 : 0);
+
+    // Catch kernels that stopped merging, or started merging areas that must stay separate.
+    if (phase.mergeable) {
+      LONGS_EQUAL(1, vmas_after_map);
+    } else {
+      LONGS_EQUAL(page_count, vmas_after_map);
+    }
+  }
+
+  result = sceKernelCheckedReleaseDirectMemory(phys_addr, window_size);
+  UNSIGNED_INT_EQUALS(0, result);
+  result = sceKernelClose(fd);
+  UNSIGNED_INT_EQUALS(0, result);
+}
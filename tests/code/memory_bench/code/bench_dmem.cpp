@@ -0,0 +1,182 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+TEST_GROUP (DmemBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+// sceKernelAvailableDirectMemorySize reports the largest free extent in [start, end). Free extents never cross the
+// allocated memory around the one found, so the ranges below and above it are searched the same way until every
+// range answers ENOMEM.
+static int32_t dmem_bench_free(uint64_t dmem_size, uint64_t* total_free, uint64_t* largest_free) {
+  struct DmemRange {
+    int64_t start;
+    int64_t end;
+  };
+
+  std::vector<DmemRange> ranges = {{0, int64_t(dmem_size)}};
+  *total_free                   = 0;
+  *largest_free                 = 0;
+  while (!ranges.empty()) {
+    DmemRange range = ranges.back();
+    ranges.pop_back();
+    if (range.start >= range.end) continue;
+
+    int64_t  phys_addr = 0;
+    uint64_t size      = 0;
+    int32_t  result    = sceKernelAvailableDirectMemorySize(range.start, range.end, 0, &phys_addr, &size);
+    if (result == ORBIS_KERNEL_ERROR_ENOMEM || (result == 0 && size == 0)) continue;
+    if (result != 0) return result;
+    *total_free += size;
+    *largest_free = std::max(*largest_free, size);
+    ranges.push_back({range.start, phys_addr});
+    ranges.push_back({phys_addr + int64_t(size), range.end});
+  }
+  return 0;
+}
+
+TEST(DmemBench, FragmentationBench) {
+  // Randomized streaming-style workload over the direct memory allocator.
+  // Allocations mix sizes, alignments and memory types, frees sometimes only release part of an allocation,
+  // which leaves the dmem map increasingly fragmented the longer this runs.
+  // The PRNG is seeded with a constant, so every run (and every emulator) sees the exact same sequence of calls.
+  struct DmemAllocation {
+    int64_t  phys_addr;
+    uint64_t size;
+  };
+
+  const uint32_t seed           = 0xD3E3;
+  const int32_t  total_ops      = 50000;
+  const int32_t  sample_every   = 2500;
+  const uint64_t page_size      = 0x4000;
+  const uint64_t alignments[]   = {0x4000, 0x10000, 0x40000, 0x100000, 0x200000};
+  const uint64_t dmem_size      = sceKernelGetDirectMemorySize();
+  const double   target_usage   = 0.6;
+  uint64_t       initial_free   = 0;
+  uint64_t       initial_extent = 0; // Largest free extent
+  uint64_t       used           = 0;
+  int32_t        alloc_failures = 0;
+  int32_t        result         = dmem_bench_free(dmem_size, &initial_free, &initial_extent);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  std::mt19937                           rng(seed);
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  std::vector<DmemAllocation>            live;
+  LatencyStats                           alloc_stats(total_ops);
+  LatencyStats                           alloc_main_stats(total_ops);
+  LatencyStats                           release_stats(total_ops);
+  LatencyStats                           checked_release_stats(total_ops);
+  live.reserve(total_ops);
+
+  // Mostly small allocations with the occasional big one, similar to a streaming texture pool.
+  auto random_size = [&]() {
+    double   roll  = chance(rng);
+    uint64_t pages = 0;
+    if (roll < 0.7) {
+      pages = std::uniform_int_distribution<uint64_t>(1, 16)(rng);
+    } else if (roll < 0.95) {
+      pages = std::uniform_int_distribution<uint64_t>(16, 256)(rng);
+    } else {
+      pages = std::uniform_int_distribution<uint64_t>(256, 2048)(rng);
+    }
+    return pages * page_size;
+  };
+
+  intest_printf("[bench] DmemBench/config seed=%u ops=%d dmem_size=%llu initial_free=%llu initial_largest_free=%llu\n", seed, total_ops,
+                (unsigned long long)dmem_size, (unsigned long long)initial_free, (unsigned long long)initial_extent);
+
+  for (int32_t op = 1; op <= total_ops; ++op) {
+    bool should_alloc = live.empty() || double(used) < target_usage * double(initial_free) * chance(rng) * 2.0;
+    if (should_alloc) {
+      uint64_t size      = random_size();
+      uint64_t alignment = alignments[std::uniform_int_distribution<int32_t>(0, 4)(rng)];
+      int32_t  mtype     = std::uniform_int_distribution<int32_t>(0, 10)(rng);
+      bool     use_main  = chance(rng) < 0.5;
+
+      int64_t  out_addr = 0;
+      uint64_t start    = bench_ticks();
+      if (use_main) {
+        result = sceKernelAllocateMainDirectMemory(size, alignment, mtype, &out_addr);
+      } else {
+        result = sceKernelAllocateDirectMemory(0, dmem_size, size, alignment, mtype, &out_addr);
+      }
+      uint64_t end = bench_ticks();
+
+      if (result == 0) {
+        (use_main ? alloc_main_stats : alloc_stats).add(end - start);
+        live.push_back({out_addr, size});
+        used += size;
+      } else {
+        // Running out of suitably aligned space is expected once the map is fragmented, anything else is a bug.
+        UNSIGNED_INT_EQUALS(ORBIS_KERNEL_ERROR_EAGAIN, result);
+        ++alloc_failures;
+      }
+    } else {
+      size_t          index      = std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng);
+      DmemAllocation& allocation = live[index];
+      uint64_t        size       = allocation.size;
+      if (size > page_size && chance(rng) < 0.25) {
+        // Release only the front half, the back half stays allocated and keeps a hole next to it.
+        size = (size / page_size / 2) * page_size;
+      }
+      bool checked = chance(rng) < 0.5;
+
+      uint64_t start = bench_ticks();
+      if (checked) {
+        result = sceKernelCheckedReleaseDirectMemory(allocation.phys_addr, size);
+      } else {
+        result = sceKernelReleaseDirectMemory(allocation.phys_addr, size);
+      }
+      uint64_t end = bench_ticks();
+      UNSIGNED_INT_EQUALS(0, result);
+      (checked ? checked_release_stats : release_stats).add(end - start);
+
+      used -= size;
+      if (size == allocation.size) {
+        allocation = live.back();
+        live.pop_back();
+      } else {
+        allocation.phys_addr += size;
+        allocation.size -= size;
+      }
+    }
+
+    if (op % sample_every == 0) {
+      // The largest contiguous free extent is what decides whether the next big allocation succeeds.
+      uint64_t total_free   = 0;
+      uint64_t largest_free = 0;
+      result                = dmem_bench_free(dmem_size, &total_free, &largest_free);
+      UNSIGNED_INT_EQUALS(0, result);
+      // Nothing but this test allocates while it runs, so the kernel has to agree with the bookkeeping.
+      LONGS_EQUAL(initial_free - used, total_free);
+      double fragmentation = total_free == 0 ? 0.0 : 1.0 - double(largest_free) / double(total_free);
+      intest_printf("[bench] DmemBench/timeline op=%d live=%zu used=%llu free=%llu largest_free=%llu fragmentation=%.3f alloc_failures=%d\n", op, live.size(),
+                    (unsigned long long)used, (unsigned long long)total_free, (unsigned long long)largest_free, fragmentation, alloc_failures);
+    }
+  }
+
+  alloc_stats.report("DmemBench", "sceKernelAllocateDirectMemory");
+  alloc_main_stats.report("DmemBench", "sceKernelAllocateMainDirectMemory");
+  release_stats.report("DmemBench", "sceKernelReleaseDirectMemory");
+  checked_release_stats.report("DmemBench", "sceKernelCheckedReleaseDirectMemory");
+
+  // Give everything back, the allocator should end up exactly where it started.
+  for (const DmemAllocation& allocation: live) {
+    result = sceKernelReleaseDirectMemory(allocation.phys_addr, allocation.size);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+
+  uint64_t final_free   = 0;
+  uint64_t final_extent = 0;
+  result                = dmem_bench_free(dmem_size, &final_free, &final_extent);
+  UNSIGNED_INT_EQUALS(0, result);
+  LONGS_EQUAL(initial_free, final_free);
+  LONGS_EQUAL(initial_extent, final_extent);
+}
@@ -0,0 +1,104 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+
+// Scratch file backing the file mappings, removed again after every test.
+static const char* fault_bench_path = "/download0/fault_bench.bin";
+
+TEST_GROUP (FaultBench) {
+  void setup() {}
+
+  void teardown() { sceKernelUnlink(fault_bench_path); }
+};
+
+// Writes one qword to every page of the mapping twice. The first pass pays for whatever the kernel deferred at map time,
+// the second pass shows the steady state cost of touching already committed memory.
+static void fault_bench_touch(const char* kind, uint64_t addr, uint64_t size) {
+  const uint64_t page_size    = 0x4000;
+  const uint64_t page_count   = size / page_size;
+  const char*    pass_names[] = {"first_touch", "warm"};
+
+  for (const char* pass_name: pass_names) {
+    LatencyStats page_stats(page_count);
+    uint64_t     begin = bench_ticks();
+    for (uint64_t i = 0; i < page_count; ++i) {
+      volatile uint64_t* page  = reinterpret_cast<volatile uint64_t*>(addr + i * page_size);
+      uint64_t           start = bench_ticks();
+      *page                    = i;
+      page_stats.add(bench_ticks() - start);
+    }
+    double total_ns = bench_ticks_to_ns(bench_ticks() - begin);
+
+    char case_name[96];
+    snprintf(case_name, sizeof(case_name), "%s/%s", kind, pass_name);
+    page_stats.report("FaultBench", case_name);
+    intest_printf("[bench] FaultBench/%s/%s/throughput bytes=%llu ns_per_page=%.1f gb_per_sec=%.3f\n", kind, pass_name, (unsigned long long)size,
+                  total_ns / double(page_count), double(size) / total_ns);
+  }
+
+  // Make sure every write landed.
+  for (uint64_t i = 0; i < page_count; ++i) {
+    LONGS_EQUAL(i, *reinterpret_cast<volatile uint64_t*>(addr + i * page_size));
+  }
+}
+
+// The same size is used for every kind so the numbers are directly comparable.
+static const uint64_t fault_bench_size = 0x8000000;
+
+TEST(FaultBench, AnonFlexibleFaultBench) {
+  uint64_t addr   = 0;
+  int32_t  result = sceKernelMmap(0, fault_bench_size, 3, 0x1000, -1, 0, &addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  fault_bench_touch("anon_flexible", addr, fault_bench_size);
+
+  result = sceKernelMunmap(addr, fault_bench_size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
+
+TEST(FaultBench, AnonPrefaultFaultBench) {
+  // Flags Anon (0x1000) | PrefaultRead (0x40000), the kernel is allowed to populate the mapping up front.
+  uint64_t addr   = 0;
+  int32_t  result = sceKernelMmap(0, fault_bench_size, 3, 0x41000, -1, 0, &addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  fault_bench_touch("anon_prefault", addr, fault_bench_size);
+
+  result = sceKernelMunmap(addr, fault_bench_size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
+
+TEST(FaultBench, DirectFaultBench) {
+  int64_t phys_addr = 0;
+  int32_t result    = sceKernelAllocateMainDirectMemory(fault_bench_size, 0x200000, 0, &phys_addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  uint64_t addr = 0;
+  result        = sceKernelMapDirectMemory(&addr, fault_bench_size, 3, 0, phys_addr, 0);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  fault_bench_touch("direct", addr, fault_bench_size);
+
+  result = sceKernelCheckedReleaseDirectMemory(phys_addr, fault_bench_size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
+
+TEST(FaultBench, FileFaultBench) {
+  // Shared file mapping, every first write has to bring in (and dirty) a page of the file.
+  int32_t fd = sceKernelOpen(fault_bench_path, 0x602, 0666);
+  CHECK(fd > 0);
+  int32_t result = sceKernelFtruncate(fd, fault_bench_size);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  uint64_t addr = 0;
+  result        = sceKernelMmap(0, fault_bench_size, 3, 0x1, fd, 0, &addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  fault_bench_touch("file_shared", addr, fault_bench_size);
+
+  result = sceKernelMunmap(addr, fault_bench_size);
+  UNSIGNED_INT_EQUALS(0, result);
+  result = sceKernelClose(fd);
+  UNSIGNED_INT_EQUALS(0, result);
+}
@@ -0,0 +1,91 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+
+TEST_GROUP (MapBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+// Size classes from a single page up to 1GB, every class is 4x the previous one.
+static const uint64_t map_bench_sizes[] = {0x4000, 0x10000, 0x40000, 0x100000, 0x400000, 0x1000000, 0x4000000, 0x10000000, 0x40000000};
+
+// Smaller mappings are cheap, run more of them so the tail percentiles mean something.
+static uint64_t map_bench_iterations(uint64_t size) {
+  return std::clamp<uint64_t>(0x10000000 / size, 32, 2000);
+}
+
+// Runs map + sceKernelMunmap cycles of the given size, timing both halves separately.
+template <typename MapFunc>
+static void map_bench_cycle(const char* api, uint64_t size, MapFunc map) {
+  uint64_t     iterations = map_bench_iterations(size);
+  LatencyStats map_stats(iterations);
+  LatencyStats unmap_stats(iterations);
+
+  for (uint64_t i = 0; i < iterations; ++i) {
+    uint64_t addr   = 0;
+    uint64_t start  = bench_ticks();
+    int32_t  result = map(&addr);
+    uint64_t end    = bench_ticks();
+    UNSIGNED_INT_EQUALS(0, result);
+    map_stats.add(end - start);
+
+    start  = bench_ticks();
+    result = sceKernelMunmap(addr, size);
+    end    = bench_ticks();
+    UNSIGNED_INT_EQUALS(0, result);
+    unmap_stats.add(end - start);
+  }
+
+  char size_str[16];
+  char name[96];
+  bench_size_str(size, size_str, sizeof(size_str));
+  snprintf(name, sizeof(name), "%s/%s", api, size_str);
+  map_stats.report("MapBench", name);
+  snprintf(name, sizeof(name), "%s+sceKernelMunmap/%s", api, size_str);
+  unmap_stats.report("MapBench", name);
+}
+
+// Flexible memory is budgeted, sizes above the remaining budget can't be mapped at all.
+static bool map_bench_fits_flexible(const char* api, uint64_t size) {
+  uint64_t available = 0;
+  int32_t  result    = sceKernelAvailableFlexibleMemorySize(&available);
+  UNSIGNED_INT_EQUALS(0, result);
+  if (size <= available) return true;
+
+  char size_str[16];
+  intest_printf("[bench] MapBench/%s/%s skipped=1 available_flexible=%llu\n", api, bench_size_str(size, size_str, sizeof(size_str)),
+                (unsigned long long)available);
+  return false;
+}
+
+TEST(MapBench, MmapAnonBench) {
+  // Anonymous mmap with flags Anon (0x1000), this is the path most games use for CPU-only allocations.
+  for (uint64_t size: map_bench_sizes) {
+    if (!map_bench_fits_flexible("sceKernelMmap", size)) continue;
+    map_bench_cycle("sceKernelMmap", size, [size](uint64_t* addr) { return sceKernelMmap(0, size, 3, 0x1000, -1, 0, addr); });
+  }
+}
+
+TEST(MapBench, MapFlexibleBench) {
+  for (uint64_t size: map_bench_sizes) {
+    if (!map_bench_fits_flexible("sceKernelMapFlexibleMemory", size)) continue;
+    map_bench_cycle("sceKernelMapFlexibleMemory", size, [size](uint64_t* addr) { return sceKernelMapFlexibleMemory(addr, size, 3, 0); });
+  }
+}
+
+TEST(MapBench, MapDirectBench) {
+  // Direct memory is allocated once per size class, only the mapping itself is measured.
+  for (uint64_t size: map_bench_sizes) {
+    int64_t phys_addr = 0;
+    int32_t result    = sceKernelAllocateMainDirectMemory(size, 0x4000, 0, &phys_addr);
+    UNSIGNED_INT_EQUALS(0, result);
+
+    map_bench_cycle("sceKernelMapDirectMemory", size, [size, phys_addr](uint64_t* addr) { return sceKernelMapDirectMemory(addr, size, 3, 0, phys_addr, 0); });
+
+    result = sceKernelCheckedReleaseDirectMemory(phys_addr, size);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+}
@@ -0,0 +1,115 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+
+TEST_GROUP (ProtectBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+// Changes every other page of [addr, addr + size) with `change`, each call splits one VMA into up to three.
+// Then reverts the same pages one by one with `revert`. With SDK 1.00 split areas don't merge again (see ProtectTest
+// in memory_test), so this measures a second protect call on an area that is already split off.
+// Finally changes the pages again and reverts the whole range with a single call that walks every split area.
+template <typename ChangeFunc, typename RevertFunc>
+static void protect_bench_run(const char* name, uint64_t addr, uint64_t size, ChangeFunc change, RevertFunc revert) {
+  const uint64_t page_size   = 0x4000;
+  const uint64_t split_pages = size / page_size / 2;
+  LatencyStats   split_stats(split_pages);
+  LatencyStats   reprotect_stats(split_pages);
+  int32_t        result = 0;
+
+  for (uint64_t i = 0; i < split_pages; ++i) {
+    uint64_t start = bench_ticks();
+    result         = change(addr + i * 2 * page_size, page_size);
+    split_stats.add(bench_ticks() - start);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+
+  for (uint64_t i = 0; i < split_pages; ++i) {
+    uint64_t start = bench_ticks();
+    result         = revert(addr + i * 2 * page_size, page_size);
+    reprotect_stats.add(bench_ticks() - start);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+
+  for (uint64_t i = 0; i < split_pages; ++i) {
+    result = change(addr + i * 2 * page_size, page_size);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+
+  // One call that has to walk every split area.
+  uint64_t start      = bench_ticks();
+  result              = revert(addr, size);
+  uint64_t full_ticks = bench_ticks() - start;
+  UNSIGNED_INT_EQUALS(0, result);
+
+  // Nothing merges, the changed page and its neighbours stay separate areas with the reverted protection.
+  int32_t first_prot = 0;
+  for (uint64_t i = 0; i < 3; ++i) {
+    uint64_t start_addr = 0;
+    uint64_t end_addr   = 0;
+    int32_t  prot       = 0;
+    result              = sceKernelQueryMemoryProtection(addr + i * page_size, &start_addr, &end_addr, &prot);
+    UNSIGNED_INT_EQUALS(0, result);
+    LONGS_EQUAL(addr + i * page_size, start_addr);
+    LONGS_EQUAL(addr + (i + 1) * page_size, end_addr);
+    if (i == 0) first_prot = prot;
+    LONGS_EQUAL(first_prot, prot);
+  }
+
+  char size_str[16];
+  char case_name[96];
+  bench_size_str(size, size_str, sizeof(size_str));
+  snprintf(case_name, sizeof(case_name), "%s/%s/split", name, size_str);
+  split_stats.report("ProtectBench", case_name);
+  snprintf(case_name, sizeof(case_name), "%s/%s/reprotect", name, size_str);
+  reprotect_stats.report("ProtectBench", case_name);
+  intest_printf("[bench] ProtectBench/%s/%s/full_revert split_pages=%llu total_ns=%.0f ns_per_split_page=%.1f\n", name, size_str,
+                (unsigned long long)split_pages, bench_ticks_to_ns(full_ticks), bench_ticks_to_ns(full_ticks) / double(split_pages));
+}
+
+TEST(ProtectBench, FlexibleProtectBench) {
+  // 1GB is above the default flexible budget, so use as much of it as is available.
+  uint64_t available = 0;
+  int32_t  result    = sceKernelAvailableFlexibleMemorySize(&available);
+  UNSIGNED_INT_EQUALS(0, result);
+  uint64_t size = std::min<uint64_t>(0x40000000, available & ~uint64_t(0x1fffff));
+  CHECK(size != 0);
+
+  uint64_t addr = 0;
+  result        = sceKernelMapFlexibleMemory(&addr, size, 3, 0);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  protect_bench_run(
+      "sceKernelMprotect/flexible", addr, size, [](uint64_t page, uint64_t len) { return sceKernelMprotect(page, len, 1); },
+      [](uint64_t page, uint64_t len) { return sceKernelMprotect(page, len, 3); });
+
+  result = sceKernelMunmap(addr, size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
+
+TEST(ProtectBench, DirectProtectBench) {
+  const uint64_t size      = 0x40000000;
+  int64_t        phys_addr = 0;
+  int32_t        result    = sceKernelAllocateMainDirectMemory(size, 0x200000, 0, &phys_addr);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  uint64_t addr = 0;
+  result        = sceKernelMapDirectMemory(&addr, size, 0x33, 0, phys_addr, 0x200000);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  protect_bench_run(
+      "sceKernelMprotect/direct", addr, size, [](uint64_t page, uint64_t len) { return sceKernelMprotect(page, len, 0x13); },
+      [](uint64_t page, uint64_t len) { return sceKernelMprotect(page, len, 0x33); });
+
+  // Memory type changes split areas the same way protection changes do.
+  protect_bench_run(
+      "sceKernelMtypeprotect/direct", addr, size, [](uint64_t page, uint64_t len) { return sceKernelMtypeprotect(page, len, 3, 0x33); },
+      [](uint64_t page, uint64_t len) { return sceKernelMtypeprotect(page, len, 0, 0x33); });
+
+  result = sceKernelCheckedReleaseDirectMemory(phys_addr, size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
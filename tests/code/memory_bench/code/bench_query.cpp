@@ -0,0 +1,103 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+#include <random>
+
+TEST_GROUP (QueryBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+TEST(QueryBench, VirtualQueryScalingBench) {
+  // Measures how sceKernelVirtualQuery scales with the number of VMAs in the process.
+  // Each VMA is a single reserved page mapped with NoCoalesce (0x400000), so adjacent entries never merge.
+  // Reserved memory doesn't count against any budget, which is what makes 50k entries possible.
+  struct ScalingRow {
+    uint64_t vmas;
+    uint64_t scan_entries;
+    double   scan_us;
+    double   scan_ns_per_entry;
+    double   point_p50_ns;
+    double   point_p99_ns;
+  };
+
+  const uint64_t  base_addr     = 0x6000000000;
+  const uint64_t  page_size     = 0x4000;
+  const uint64_t  vma_counts[]  = {10, 100, 1000, 10000, 50000};
+  const int32_t   scan_passes   = 5;
+  const int32_t   point_queries = 10000;
+  ScalingRow      rows[5]       = {};
+  uint64_t        mapped_count  = 0;
+  int32_t         row_count     = 0;
+  int32_t         result        = 0;
+  std::mt19937_64 rng(0x5EED);
+
+  for (uint64_t vma_count: vma_counts) {
+    // Grow the window up to the requested number of entries.
+    for (; mapped_count < vma_count; ++mapped_count) {
+      uint64_t addr = base_addr + mapped_count * page_size;
+      // Flags Fixed (0x10) | NoCoalesce (0x400000)
+      result = sceKernelReserveVirtualRange(&addr, page_size, 0x400010, 0);
+      UNSIGNED_INT_EQUALS(0, result);
+    }
+
+    // Full scans, the same walk mem_scan performs.
+    uint64_t scan_entries = 0;
+    uint64_t scan_ticks   = 0;
+    for (int32_t pass = 0; pass < scan_passes; ++pass) {
+      uint64_t entries = 0;
+      uint64_t addr    = 0;
+      uint64_t start   = bench_ticks();
+      while (true) {
+        OrbisKernelVirtualQueryInfo info = {};
+        if (sceKernelVirtualQuery(addr, 1, &info, sizeof(info)) != 0) break;
+        addr = info.end;
+        ++entries;
+      }
+      scan_ticks += bench_ticks() - start;
+      scan_entries = entries;
+    }
+    CHECK(scan_entries >= vma_count);
+
+    // Point queries at random pages inside the window.
+    std::uniform_int_distribution<uint64_t> page_dist(0, vma_count - 1);
+    LatencyStats                            point_stats(point_queries);
+    for (int32_t i = 0; i < point_queries; ++i) {
+      uint64_t                    addr  = base_addr + page_dist(rng) * page_size;
+      OrbisKernelVirtualQueryInfo info  = {};
+      uint64_t                    start = bench_ticks();
+      result                            = sceKernelVirtualQuery(addr, 0, &info, sizeof(info));
+      point_stats.add(bench_ticks() - start);
+      UNSIGNED_INT_EQUALS(0, result);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "point/%llu", (unsigned long long)vma_count);
+    point_stats.report("QueryBench", name);
+
+    ScalingRow& row       = rows[row_count++];
+    row.vmas              = vma_count;
+    row.scan_entries      = scan_entries;
+    row.scan_us           = bench_ticks_to_ns(scan_ticks) / scan_passes / 1000.0;
+    row.scan_ns_per_entry = row.scan_us * 1000.0 / double(scan_entries);
+    row.point_p50_ns      = point_stats.percentile_ns(0.5);
+    row.point_p99_ns      = point_stats.percentile_ns(0.99);
+    intest_printf("[bench] QueryBench/scan/%llu entries=%llu scan_us=%.1f ns_per_entry=%.1f\n", (unsigned long long)vma_count, (unsigned long long)scan_entries,
+                  row.scan_us, row.scan_ns_per_entry);
+  }
+
+  // Release the whole window in one call, munmap handles reserved areas.
+  result = sceKernelMunmap(base_addr, mapped_count * page_size);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  // Summary table. With a balanced tree point query cost should barely move between rows,
+  // a linear lookup shows up as point latency growing with the VMA count.
+  intest_printf("\n%8s | %8s | %12s | %12s | %12s | %12s\n", "vmas", "entries", "scan_us", "scan_ns/vma", "point_p50_ns", "point_p99_ns");
+  for (int32_t i = 0; i < row_count; ++i) {
+    intest_printf("%8llu | %8llu | %12.1f | %12.1f | %12.0f | %12.0f\n", (unsigned long long)rows[i].vmas, (unsigned long long)rows[i].scan_entries,
+                  rows[i].scan_us, rows[i].scan_ns_per_entry, rows[i].point_p50_ns, rows[i].point_p99_ns);
+  }
+  intest_printf("\n");
+}
@@ -0,0 +1,150 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+TEST_GROUP (StreamBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+// Generated at build time by gen_stream_asset.cmake, size is set with INTEST_STREAM_ASSET_MB.
+static const char* stream_bench_path = "/app0/assets/misc/stream_bench.bin";
+
+// Every 4KB page of the asset starts with its page index, see gen_stream_asset.cmake.
+static const uint64_t stream_bench_page_size = 0x1000;
+
+// The first 16 bytes every page of the asset should start with, two words per page. Built before anything is timed,
+// so checking a page costs the timed loops two compares.
+static std::vector<uint64_t> stream_bench_headers(uint64_t file_size) {
+  const uint64_t        page_count = file_size / stream_bench_page_size;
+  std::vector<uint64_t> headers(page_count * 2);
+  for (uint64_t page = 0; page < page_count; ++page) {
+    char header[17];
+    snprintf(header, sizeof(header), "%015llu\n", (unsigned long long)page);
+    memcpy(&headers[page * 2], header, 16);
+  }
+  return headers;
+}
+
+// Position weighted checksum, reading the right bytes in the wrong order changes the result.
+// Pages that don't start with the header of their offset in the file are counted in bad_pages.
+static uint64_t stream_bench_block_sum(const void* data, uint64_t size, uint64_t block_index, const std::vector<uint64_t>& headers, uint64_t* bad_pages) {
+  const uint64_t* words = static_cast<const uint64_t*>(data);
+  const uint64_t  count = size / sizeof(uint64_t);
+  uint64_t        sum   = 0;
+  for (uint64_t i = 0; i < count; ++i) {
+    sum += words[i];
+  }
+
+  const uint64_t  page_words = stream_bench_page_size / sizeof(uint64_t);
+  const uint64_t* expected   = &headers[block_index * (size / stream_bench_page_size) * 2];
+  for (uint64_t page = 0; page < size / stream_bench_page_size; ++page) {
+    if (words[page * page_words] != expected[page * 2] || words[page * page_words + 1] != expected[page * 2 + 1]) ++*bad_pages;
+  }
+  return sum * (block_index + 1);
+}
+
+static void stream_bench_report(const char* method, const char* order, uint64_t block_size, uint64_t bytes, uint64_t ticks) {
+  char   size_str[16];
+  double total_ns = bench_ticks_to_ns(ticks);
+  intest_printf("[bench] StreamBench/%s/%s/%s bytes=%llu total_ns=%.0f gb_per_sec=%.3f\n", method, order,
+                bench_size_str(block_size, size_str, sizeof(size_str)), (unsigned long long)bytes, total_ns, double(bytes) / total_ns);
+}
+
+// sceKernelRead into a single buffer, random order seeks before every block.
+static uint64_t stream_bench_read(int32_t fd, const std::vector<uint64_t>& order, uint64_t block_size, bool seek, const std::vector<uint64_t>& headers,
+                                  uint64_t* ticks) {
+  std::vector<uint64_t> buffer(block_size / sizeof(uint64_t));
+  uint64_t              checksum  = 0;
+  uint64_t              bad_pages = 0;
+  int64_t               offset    = sceKernelLseek(fd, 0, 0);
+  LONGS_EQUAL(0, offset);
+
+  uint64_t start = bench_ticks();
+  for (uint64_t block: order) {
+    if (seek) sceKernelLseek(fd, int64_t(block * block_size), 0);
+    int64_t read = sceKernelRead(fd, buffer.data(), block_size);
+    if (read != int64_t(block_size)) {
+      // Assert only on failure, keeps CppUTest bookkeeping out of the timed loop.
+      LONGS_EQUAL(block_size, read);
+    }
+    checksum += stream_bench_block_sum(buffer.data(), block_size, block, headers, &bad_pages);
+  }
+  *ticks = bench_ticks() - start;
+  LONGS_EQUAL(0, bad_pages);
+  return checksum;
+}
+
+// Maps the whole file with the given flags and reads it in place. Map and unmap are part of the measurement.
+static uint64_t stream_bench_mmap(int32_t fd, uint64_t file_size, int32_t flags, const std::vector<uint64_t>& order, uint64_t block_size,
+                                  const std::vector<uint64_t>& headers, uint64_t* ticks) {
+  uint64_t checksum  = 0;
+  uint64_t bad_pages = 0;
+  uint64_t addr      = 0;
+  uint64_t start     = bench_ticks();
+  int32_t  result    = sceKernelMmap(0, file_size, 1, flags, fd, 0, &addr);
+  UNSIGNED_INT_EQUALS(0, result);
+  for (uint64_t block: order) {
+    checksum += stream_bench_block_sum(reinterpret_cast<const void*>(addr + block * block_size), block_size, block, headers, &bad_pages);
+  }
+  result = sceKernelMunmap(addr, file_size);
+  *ticks = bench_ticks() - start;
+  UNSIGNED_INT_EQUALS(0, result);
+  LONGS_EQUAL(0, bad_pages);
+  return checksum;
+}
+
+TEST(StreamBench, FileStreamBench) {
+  // Streams the generated asset through sceKernelRead and through file mappings, sequentially and in random block order.
+  // Every method has to produce the same checksum for a given block size.
+  // One untimed pass runs first, so all rows are measured with the file in the page cache.
+  const uint64_t block_sizes[] = {0x1000, 0x4000, 0x10000, 0x40000, 0x100000, 0x800000};
+
+  int32_t fd = sceKernelOpen(stream_bench_path, 0, 0666);
+  CHECK(fd > 0);
+  int64_t file_size = sceKernelLseek(fd, 0, 2);
+  CHECK(file_size >= 0x800000);
+
+  std::vector<uint64_t> headers = stream_bench_headers(uint64_t(file_size));
+  std::vector<uint64_t> warmup(file_size / 0x800000);
+  uint64_t              ticks = 0;
+  for (uint64_t i = 0; i < warmup.size(); ++i) {
+    warmup[i] = i;
+  }
+  stream_bench_read(fd, warmup, 0x800000, false, headers, &ticks);
+
+  std::mt19937 rng(0x5EAD);
+  for (uint64_t block_size: block_sizes) {
+    const uint64_t        block_count = uint64_t(file_size) / block_size;
+    const uint64_t        bytes       = block_count * block_size;
+    std::vector<uint64_t> sequential(block_count);
+    for (uint64_t i = 0; i < block_count; ++i) {
+      sequential[i] = i;
+    }
+    std::vector<uint64_t> random = sequential;
+    std::shuffle(random.begin(), random.end(), rng);
+
+    uint64_t expected = stream_bench_read(fd, sequential, block_size, false, headers, &ticks);
+    stream_bench_report("sceKernelRead", "sequential", block_size, bytes, ticks);
+    CHECK(expected == stream_bench_read(fd, random, block_size, true, headers, &ticks));
+    stream_bench_report("sceKernelRead", "random", block_size, bytes, ticks);
+
+    // Flags Shared (0x1) and Private (0x2)
+    CHECK(expected == stream_bench_mmap(fd, file_size, 0x1, sequential, block_size, headers, &ticks));
+    stream_bench_report("mmap_shared", "sequential", block_size, bytes, ticks);
+    CHECK(expected == stream_bench_mmap(fd, file_size, 0x1, random, block_size, headers, &ticks));
+    stream_bench_report("mmap_shared", "random", block_size, bytes, ticks);
+    CHECK(expected == stream_bench_mmap(fd, file_size, 0x2, sequential, block_size, headers, &ticks));
+    stream_bench_report("mmap_private", "sequential", block_size, bytes, ticks);
+    CHECK(expected == stream_bench_mmap(fd, file_size, 0x2, random, block_size, headers, &ticks));
+    stream_bench_report("mmap_private", "random", block_size, bytes, ticks);
+  }
+
+  int32_t result = sceKernelClose(fd);
+  UNSIGNED_INT_EQUALS(0, result);
+}
@@ -0,0 +1,179 @@
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+#include <atomic>
+#include <cstdio>
+
+TEST_GROUP (ThreadBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+struct ThreadBenchWorker {
+  // Inputs
+  uint64_t          base_addr;
+  int64_t           phys_addr;
+  int32_t           iterations;
+  std::atomic<int>* ready;
+  std::atomic<int>* go; // 0 wait, 1 run, -1 leave without running
+
+  // Outputs, only read by the main thread after join.
+  LatencyStats mmap_stats;
+  LatencyStats munmap_stats;
+  LatencyStats direct_stats;
+  LatencyStats query_stats;
+  uint64_t     elapsed_ticks;
+  int32_t      errors;
+  int32_t      first_error;
+};
+
+// Size of every mapping made by a worker, workers never touch each other's address range.
+static const uint64_t thread_bench_map_size = 0x10000;
+
+// CppUTest checks can't be used off the main thread, errors are collected and checked after join.
+static void thread_bench_track(ThreadBenchWorker* worker, int32_t result) {
+  if (result != 0 && worker->errors++ == 0) worker->first_error = result;
+}
+
+static void* thread_bench_entry(void* arg) {
+  ThreadBenchWorker* worker = static_cast<ThreadBenchWorker*>(arg);
+  worker->ready->fetch_add(1);
+  // Yield while waiting, with 7 workers on 7 cores a bare spin can keep the main thread from releasing them.
+  int32_t go = 0;
+  while ((go = worker->go->load()) == 0) {
+    scePthreadYield();
+  }
+  if (go < 0) return nullptr;
+
+  uint64_t begin = bench_ticks();
+  for (int32_t i = 0; i < worker->iterations; ++i) {
+    // Flags Fixed (0x10) | Anon (0x1000)
+    uint64_t addr   = worker->base_addr;
+    uint64_t start  = bench_ticks();
+    int32_t  result = sceKernelMmap(addr, thread_bench_map_size, 3, 0x1010, -1, 0, &addr);
+    worker->mmap_stats.add(bench_ticks() - start);
+    thread_bench_track(worker, result);
+
+    OrbisKernelVirtualQueryInfo info = {};
+    start                            = bench_ticks();
+    result                           = sceKernelVirtualQuery(addr, 0, &info, sizeof(info));
+    worker->query_stats.add(bench_ticks() - start);
+    thread_bench_track(worker, result);
+
+    start  = bench_ticks();
+    result = sceKernelMunmap(addr, thread_bench_map_size);
+    worker->munmap_stats.add(bench_ticks() - start);
+    thread_bench_track(worker, result);
+
+    addr   = worker->base_addr + thread_bench_map_size;
+    start  = bench_ticks();
+    result = sceKernelMapDirectMemory(&addr, thread_bench_map_size, 3, 0x10, worker->phys_addr, 0);
+    worker->direct_stats.add(bench_ticks() - start);
+    thread_bench_track(worker, result);
+
+    result = sceKernelMunmap(addr, thread_bench_map_size);
+    thread_bench_track(worker, result);
+  }
+  worker->elapsed_ticks = bench_ticks() - begin;
+  return nullptr;
+}
+
+TEST(ThreadBench, ContentionBench) {
+  // Every worker hammers the memory APIs on its own address range and its own direct memory,
+  // so any slowdown from adding threads comes from locking inside the kernel (or emulator), not from real conflicts.
+  // 6 and 7 threads match the core counts available in isSixCpuMode and isSevenCpuMode, see SfoAttributes.
+  const int32_t  thread_counts[] = {1, 2, 4, 6, 7};
+  const int32_t  iterations      = 2000;
+  const uint64_t base_addr       = 0x8000000000;
+  const uint64_t range_stride    = 0x100000000;
+  double         single_ops_sec  = 0.0;
+
+  // One direct memory chunk per worker, allocated up front so allocation isn't part of the measurement.
+  int64_t phys_addrs[7] = {};
+  for (int64_t& phys_addr: phys_addrs) {
+    int32_t result = sceKernelAllocateMainDirectMemory(thread_bench_map_size, 0x10000, 0, &phys_addr);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+
+  for (int32_t thread_count: thread_counts) {
+    std::atomic<int>  ready   = 0;
+    std::atomic<int>  go      = 0;
+    ThreadBenchWorker workers[7];
+    void*             threads[7] = {};
+
+    for (int32_t i = 0; i < thread_count; ++i) {
+      ThreadBenchWorker& worker = workers[i];
+      worker.base_addr          = base_addr + i * range_stride;
+      worker.phys_addr          = phys_addrs[i];
+      worker.iterations         = iterations;
+      worker.ready              = &ready;
+      worker.go                 = &go;
+      worker.elapsed_ticks      = 0;
+      worker.errors             = 0;
+      worker.first_error        = 0;
+      worker.mmap_stats.samples.reserve(iterations);
+      worker.munmap_stats.samples.reserve(iterations);
+      worker.direct_stats.samples.reserve(iterations);
+      worker.query_stats.samples.reserve(iterations);
+
+      char name[32];
+      snprintf(name, sizeof(name), "ThreadBench%d", i);
+      int32_t result = scePthreadCreate(&threads[i], nullptr, thread_bench_entry, &worker, name);
+      if (result != 0) {
+        // Let the workers already started leave before failing, they would wait forever otherwise.
+        go.store(-1);
+        for (int32_t j = 0; j < i; ++j) {
+          scePthreadJoin(threads[j], nullptr);
+        }
+      }
+      UNSIGNED_INT_EQUALS(0, result);
+    }
+
+    // Release all workers at once.
+    while (ready.load() != thread_count) {
+      scePthreadYield();
+    }
+    go.store(1);
+
+    LatencyStats mmap_stats;
+    LatencyStats munmap_stats;
+    LatencyStats direct_stats;
+    LatencyStats query_stats;
+    uint64_t     slowest_ticks = 0;
+    for (int32_t i = 0; i < thread_count; ++i) {
+      int32_t result = scePthreadJoin(threads[i], nullptr);
+      UNSIGNED_INT_EQUALS(0, result);
+      UNSIGNED_INT_EQUALS(0, workers[i].first_error);
+      LONGS_EQUAL(0, workers[i].errors);
+
+      mmap_stats.merge(workers[i].mmap_stats);
+      munmap_stats.merge(workers[i].munmap_stats);
+      direct_stats.merge(workers[i].direct_stats);
+      query_stats.merge(workers[i].query_stats);
+      slowest_ticks = std::max(slowest_ticks, workers[i].elapsed_ticks);
+    }
+
+    // An iteration is five memory calls, throughput is measured against the slowest worker.
+    double total_ops = double(thread_count) * iterations * 5;
+    double ops_sec   = total_ops * 1000000000.0 / bench_ticks_to_ns(slowest_ticks);
+    if (thread_count == 1) single_ops_sec = ops_sec;
+    double efficiency = ops_sec / (single_ops_sec * thread_count);
+
+    char name[64];
+    snprintf(name, sizeof(name), "threads%d/sceKernelMmap", thread_count);
+    mmap_stats.report("ThreadBench", name);
+    snprintf(name, sizeof(name), "threads%d/sceKernelMunmap", thread_count);
+    munmap_stats.report("ThreadBench", name);
+    snprintf(name, sizeof(name), "threads%d/sceKernelMapDirectMemory", thread_count);
+    direct_stats.report("ThreadBench", name);
+    snprintf(name, sizeof(name), "threads%d/sceKernelVirtualQuery", thread_count);
+    query_stats.report("ThreadBench", name);
+    intest_printf("[bench] ThreadBench/threads%d/aggregate ops=%.0f ops_per_sec=%.0f scaling_efficiency=%.3f\n", thread_count, total_ops, ops_sec, efficiency);
+  }
+
+  for (int64_t phys_addr: phys_addrs) {
+    int32_t result = sceKernelCheckedReleaseDirectMemory(phys_addr, thread_bench_map_size);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+}
@@ -0,0 +1,26 @@
+# Generates the StreamBench input file.
+# Usage: cmake -DOUTPUT=<file> -DSIZE_MB=<size> -P gen_stream_asset.cmake
+# Every 4KB page starts with its page index as 15 zero padded decimal digits and a newline, StreamBench checks these
+# to catch reads from the wrong offset. The rest of the page is filler.
+if(NOT OUTPUT OR NOT SIZE_MB)
+  message(FATAL_ERROR "gen_stream_asset.cmake: OUTPUT and SIZE_MB must be set")
+endif()
+
+string(REPEAT "0123456789abcdef" 255 filler)
+file(WRITE "${OUTPUT}.tmp" "")
+
+# Written 1MB at a time, 256 pages each.
+math(EXPR last_block "${SIZE_MB} - 1")
+foreach(block RANGE ${last_block})
+  set(block_data "")
+  foreach(page_in_block RANGE 255)
+    math(EXPR page "${block} * 256 + ${page_in_block}")
+    string(LENGTH "${page}" page_len)
+    math(EXPR pad_len "15 - ${page_len}")
+    string(REPEAT "0" ${pad_len} pad)
+    string(APPEND block_data "${pad}${page}\n${filler}")
+  endforeach()
+  file(APPEND "${OUTPUT}.tmp" "${block_data}")
+endforeach()
+
+file(RENAME "${OUTPUT}.tmp" "${OUTPUT}")
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "bench.h"
+
+#include <CppUTest/TestHarness.h>
+
+// Pools are committed and decommitted in 64KB chunks.
+static const uint64_t pool_chunk_size = 0x10000;
+
+// Pool expansion takes direct memory away from the process for good, there is no call to give it back.
+// Every test expands by what it needs and leaves the rest of the direct memory alone.
+static inline void pool_expand(uint64_t size) {
+  int64_t phys_addr = 0;
+  int32_t result    = sceKernelMemoryPoolExpand(0, sceKernelGetDirectMemorySize(), size, pool_chunk_size, &phys_addr);
+  UNSIGNED_INT_EQUALS(0, result);
+}
+
+static inline uint64_t pool_reserve(uint64_t size) {
+  uint64_t addr   = 0;
+  int32_t  result = sceKernelMemoryPoolReserve(0, size, 0x200000, 0, &addr);
+  UNSIGNED_INT_EQUALS(0, result);
+  CHECK(addr != 0);
+  return addr;
+}
+
+// Checks the VirtualQuery bits for the area containing addr, a pool reservation is always pooled.
+static inline void pool_check_state(uint64_t addr, bool committed) {
+  OrbisKernelVirtualQueryInfo info   = {};
+  int32_t                     result = sceKernelVirtualQuery(addr, 0, &info, sizeof(info));
+  UNSIGNED_INT_EQUALS(0, result);
+  CHECK(info.start <= addr && addr < info.end);
+  LONGS_EQUAL(1, info.is_pooled);
+  LONGS_EQUAL(committed ? 1 : 0, info.is_committed);
+}
@@ -0,0 +1,99 @@
+#include "pool.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+TEST_GROUP (PoolBench) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+TEST(PoolBench, CommitDecommitBench) {
+  // Commits the whole pool in blocks of the given size, then decommits it again, first in address order
+  // and then in a shuffled order. Small blocks in random order is what the pooled allocators in engines do,
+  // large blocks in order is the best case an implementation can hope for.
+  const uint64_t block_sizes[] = {0x10000, 0x40000, 0x100000, 0x200000};
+  const uint64_t pool_size     = 0x4000000;
+  pool_expand(pool_size);
+  uint64_t addr = pool_reserve(pool_size);
+
+  std::mt19937 rng(0x9002);
+  for (uint64_t block_size: block_sizes) {
+    const uint64_t        block_count = pool_size / block_size;
+    std::vector<uint64_t> order(block_count);
+    for (uint64_t i = 0; i < block_count; ++i) {
+      order[i] = i;
+    }
+
+    const char* order_names[] = {"sequential", "random"};
+    for (const char* order_name: order_names) {
+      LatencyStats commit_stats(block_count);
+      LatencyStats decommit_stats(block_count);
+      for (uint64_t block: order) {
+        uint64_t start  = bench_ticks();
+        int32_t  result = sceKernelMemoryPoolCommit(addr + block * block_size, block_size, 0, 3, 0);
+        commit_stats.add(bench_ticks() - start);
+        UNSIGNED_INT_EQUALS(0, result);
+      }
+      pool_check_state(addr, true);
+      pool_check_state(addr + pool_size - pool_chunk_size, true);
+
+      for (uint64_t block: order) {
+        uint64_t start  = bench_ticks();
+        int32_t  result = sceKernelMemoryPoolDecommit(addr + block * block_size, block_size, 0);
+        decommit_stats.add(bench_ticks() - start);
+        UNSIGNED_INT_EQUALS(0, result);
+      }
+      pool_check_state(addr, false);
+      pool_check_state(addr + pool_size - pool_chunk_size, false);
+
+      char size_str[16];
+      char case_name[96];
+      bench_size_str(block_size, size_str, sizeof(size_str));
+      snprintf(case_name, sizeof(case_name), "sceKernelMemoryPoolCommit/%s/%s", order_name, size_str);
+      commit_stats.report("PoolBench", case_name);
+      snprintf(case_name, sizeof(case_name), "sceKernelMemoryPoolDecommit/%s/%s", order_name, size_str);
+      decommit_stats.report("PoolBench", case_name);
+
+      std::shuffle(order.begin(), order.end(), rng);
+    }
+  }
+
+  int32_t result = sceKernelMunmap(addr, pool_size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
+
+TEST(PoolBench, QueryBench) {
+  // VirtualQuery over a pool window where every other chunk is committed, the worst case for an
+  // implementation that keeps one area per commit.
+  const uint64_t pool_size   = 0x4000000;
+  const uint64_t chunk_count = pool_size / pool_chunk_size;
+  const int32_t  queries     = 10000;
+  pool_expand(pool_size / 2);
+  uint64_t addr = pool_reserve(pool_size);
+
+  for (uint64_t i = 0; i < chunk_count; i += 2) {
+    int32_t result = sceKernelMemoryPoolCommit(addr + i * pool_chunk_size, pool_chunk_size, 0, 3, 0);
+    UNSIGNED_INT_EQUALS(0, result);
+  }
+
+  std::mt19937 rng(0x9003);
+  LatencyStats query_stats(queries);
+  for (int32_t i = 0; i < queries; ++i) {
+    uint64_t                    chunk  = std::uniform_int_distribution<uint64_t>(0, chunk_count - 1)(rng);
+    OrbisKernelVirtualQueryInfo info   = {};
+    uint64_t                    start  = bench_ticks();
+    int32_t                     result = sceKernelVirtualQuery(addr + chunk * pool_chunk_size, 0, &info, sizeof(info));
+    query_stats.add(bench_ticks() - start);
+    UNSIGNED_INT_EQUALS(0, result);
+    LONGS_EQUAL((chunk % 2) == 0 ? 1 : 0, info.is_committed);
+  }
+  query_stats.report("PoolBench", "sceKernelVirtualQuery/checkerboard");
+
+  // Unmapping the window decommits everything in it.
+  int32_t result = sceKernelMunmap(addr, pool_size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
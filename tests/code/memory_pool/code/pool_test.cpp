@@ -0,0 +1,147 @@
+#include "pool.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+TEST_GROUP (PoolTests) {
+  void setup() {}
+
+  void teardown() {}
+};
+
+TEST(PoolTests, BasicTest) {
+  const uint64_t pool_size   = 0x1000000;
+  const uint64_t window_size = 0x10000000;
+  pool_expand(pool_size);
+  uint64_t addr = pool_reserve(window_size);
+
+  // A fresh reservation is pooled but nothing is committed yet.
+  for (uint64_t offset = 0; offset < window_size; offset += pool_chunk_size) {
+    pool_check_state(addr + offset, false);
+  }
+
+  // Commit a single chunk in the middle of the window, only that chunk changes.
+  uint64_t chunk  = addr + 0x100000;
+  int32_t  result = sceKernelMemoryPoolCommit(chunk, pool_chunk_size, 0, 3, 0);
+  UNSIGNED_INT_EQUALS(0, result);
+  pool_check_state(chunk - pool_chunk_size, false);
+  pool_check_state(chunk, true);
+  pool_check_state(chunk + pool_chunk_size - 1, true);
+  pool_check_state(chunk + pool_chunk_size, false);
+
+  // Committed memory is usable.
+  memset(reinterpret_cast<void*>(chunk), 0xAB, pool_chunk_size);
+  LONGS_EQUAL(0xAB, *reinterpret_cast<volatile uint8_t*>(chunk + pool_chunk_size - 1));
+
+  result = sceKernelMemoryPoolDecommit(chunk, pool_chunk_size, 0);
+  UNSIGNED_INT_EQUALS(0, result);
+  pool_check_state(chunk, false);
+
+  // Pools only grow and how far depends on which other tests ran before, so ask the pool what is left.
+  // Committing one chunk more than that has to fail.
+  OrbisKernelMemoryPoolBlockStats stats = {};
+  result                                = sceKernelMemoryPoolGetBlockStats(&stats, sizeof(stats));
+  UNSIGNED_INT_EQUALS(0, result);
+  uint64_t over_size = uint64_t(stats.available_flushed_blocks + stats.available_cached_blocks) * pool_chunk_size + pool_chunk_size;
+  uint64_t over_addr = pool_reserve(over_size);
+  result             = sceKernelMemoryPoolCommit(over_addr, over_size, 0, 3, 0);
+  CHECK(result != 0);
+  result = sceKernelMunmap(over_addr, over_size);
+  UNSIGNED_INT_EQUALS(0, result);
+
+  // Committing the whole pool in one call works.
+  result = sceKernelMemoryPoolCommit(addr, pool_size, 0, 3, 0);
+  UNSIGNED_INT_EQUALS(0, result);
+  pool_check_state(addr, true);
+  pool_check_state(addr + pool_size - pool_chunk_size, true);
+  pool_check_state(addr + pool_size, false);
+  result = sceKernelMemoryPoolDecommit(addr, pool_size, 0);
+  UNSIGNED_INT_EQUALS(0, result);
+  pool_check_state(addr, false);
+
+  result = sceKernelMunmap(addr, window_size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
+
+TEST(PoolTests, RandomizedTest) {
+  // Randomized commit/decommit of runs of chunks over a window four times larger than the pool.
+  // A shadow copy of the commit state is kept and compared against VirtualQuery periodically.
+  // Every committed chunk gets a tag written to it, tags are checked before decommit, so two commits
+  // that end up on the same physical memory are caught.
+  const uint32_t seed         = 0x9001;
+  const int32_t  total_ops    = 20000;
+  const int32_t  verify_every = 2000;
+  const uint64_t pool_size    = 0x4000000;
+  const uint64_t window_size  = pool_size * 4;
+  const uint64_t chunk_count  = window_size / pool_chunk_size;
+  const uint64_t pool_chunks  = pool_size / pool_chunk_size;
+  uint64_t       committed    = 0;
+  int32_t        skipped      = 0;
+  pool_expand(pool_size);
+  uint64_t addr = pool_reserve(window_size);
+
+  std::mt19937      rng(seed);
+  std::vector<bool> state(chunk_count, false);
+  LatencyStats      commit_stats(total_ops);
+  LatencyStats      decommit_stats(total_ops);
+
+  auto chunk_tag = [&](uint64_t index) { return (addr + index * pool_chunk_size) ^ 0x5A5A5A5A5A5A5A5Aull; };
+
+  for (int32_t op = 1; op <= total_ops; ++op) {
+    uint64_t run   = std::uniform_int_distribution<uint64_t>(1, 16)(rng);
+    uint64_t first = std::uniform_int_distribution<uint64_t>(0, chunk_count - run)(rng);
+    uint64_t count = 0;
+    for (uint64_t i = first; i < first + run; ++i) {
+      count += state[i] ? 1 : 0;
+    }
+
+    uint64_t run_addr = addr + first * pool_chunk_size;
+    uint64_t run_size = run * pool_chunk_size;
+    if (count == 0 && committed + run <= pool_chunks) {
+      uint64_t start  = bench_ticks();
+      int32_t  result = sceKernelMemoryPoolCommit(run_addr, run_size, 0, 3, 0);
+      commit_stats.add(bench_ticks() - start);
+      UNSIGNED_INT_EQUALS(0, result);
+      for (uint64_t i = first; i < first + run; ++i) {
+        state[i]                                                 = true;
+        *reinterpret_cast<uint64_t*>(addr + i * pool_chunk_size) = chunk_tag(i);
+      }
+      committed += run;
+    } else if (count == run) {
+      for (uint64_t i = first; i < first + run; ++i) {
+        UNSIGNED_LONGS_EQUAL(chunk_tag(i), *reinterpret_cast<uint64_t*>(addr + i * pool_chunk_size));
+        state[i] = false;
+      }
+      uint64_t start  = bench_ticks();
+      int32_t  result = sceKernelMemoryPoolDecommit(run_addr, run_size, 0);
+      decommit_stats.add(bench_ticks() - start);
+      UNSIGNED_INT_EQUALS(0, result);
+      committed -= run;
+    } else {
+      // Partially committed run, or the pool is full.
+      ++skipped;
+    }
+
+    if (op % verify_every == 0) {
+      for (uint64_t i = 0; i < chunk_count; ++i) {
+        pool_check_state(addr + i * pool_chunk_size, state[i]);
+      }
+      intest_printf("[bench] PoolTests/randomized/timeline op=%d committed_chunks=%llu commits=%zu decommits=%zu skipped=%d\n", op,
+                    (unsigned long long)committed, commit_stats.count(), decommit_stats.count(), skipped);
+    }
+  }
+
+  commit_stats.report("PoolTests", "randomized/sceKernelMemoryPoolCommit");
+  decommit_stats.report("PoolTests", "randomized/sceKernelMemoryPoolDecommit");
+
+  // Unmapping the window returns every committed chunk to the pool.
+  int32_t result = sceKernelMunmap(addr, window_size);
+  UNSIGNED_INT_EQUALS(0, result);
+  addr   = pool_reserve(window_size);
+  result = sceKernelMemoryPoolCommit(addr, pool_size, 0, 3, 0);
+  UNSIGNED_INT_EQUALS(0, result);
+  result = sceKernelMunmap(addr, window_size);
+  UNSIGNED_INT_EQUALS(0, result);
+}
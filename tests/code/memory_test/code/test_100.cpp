@@ -7,7 +7,7 @@
 TEST_GROUP (MemoryTests) {
   void setup() { // Before each test, call mem_scan to print out memory map information.
     // This will provide an indicator of how the memory map looks, which can help with debugging strange behavior during tests.
-    printf("Before test:\n");
+    intest_printf("Before test:\n");
     mem_scan();
   }
 
@@ -483,20 +483,6 @@ TEST(MemoryTests, MapMemoryTest) {
 
   // When fixed is not specified, address will search for a free area, starting at a base of 0x200000000.
   // libc mappings follow this behavior, so we can't hardcode an address here, instead search manually for a free address to check against.
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   OrbisKernelVirtualQueryInfo info;
   info = {};
 
@@ -1077,21 +1063,6 @@ TEST(MemoryTests, DeviceFileTest) {
   result = sceKernelCheckedReleaseDirectMemory(phys_addr, 0x10000);
   UNSIGNED_INT_EQUALS(0, result);
 
-  // Define OrbisKernelVirtualQueryInfo struct
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   OrbisKernelVirtualQueryInfo info;
   info = {};
 
@@ -1682,21 +1653,6 @@ TEST(MemoryTests, FileMappingTest) {
   LONGS_EQUAL(3, prot);
 
   // Run virtual query to check details
-  // Need to define struct first.
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   OrbisKernelVirtualQueryInfo info;
   info   = {};
   result = sceKernelVirtualQuery(output_addr, 0, &info, sizeof(info));
@@ -1991,20 +1947,6 @@ TEST(MemoryTests, FlexibleTest) {
   UNSIGNED_INT_EQUALS(0, result);
 
   // While we're here, make sure stored memory info matches expectations for flexible memory.
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   OrbisKernelVirtualQueryInfo info;
   info   = {};
   result = sceKernelVirtualQuery(addr_out, 0, &info, sizeof(info));
@@ -2161,20 +2103,6 @@ TEST(MemoryTests, DirectTest) {
   UNSIGNED_INT_EQUALS(0, result);
 
   // While we're here, make sure stored memory info matches expectations for direct memory.
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   OrbisKernelVirtualQueryInfo info;
   info   = {};
   result = sceKernelVirtualQuery(addr, 0, &info, sizeof(info));
@@ -2616,61 +2544,8 @@ TEST(MemoryTests, CoalescingTest) {
     Additionally, address and offset must be sequential.
     Firmwares below 5.50 also require the same calling address (anon_addr).
   */
-  // Define lambdas for memory calls. This (along with the optnone attribute) is needed to ensure a static calling address
+  // All mappings go through intest_map and intest_unmap, which keeps the calling address static
   // (which is one of the things checked when merging vmem areas).
-  auto map_func = [](uint64_t* addr, uint64_t size, int32_t fd, uint64_t offset, int32_t flags, int32_t prot = 0x33) __attribute__((optnone)) {
-    // This function is effectively an mmap wrapper, except for the case of mapping direct memory.
-    if (fd == -1 && offset != 0) {
-      // Used for a direct memory mapping, use sceKernelAllocateDirectMemory and sceKernelMapDirectMemory.
-      int64_t phys_addr = 0;
-      int32_t result    = sceKernelAllocateDirectMemory(offset, offset + size, size, 0, 0, &phys_addr);
-      if (result < 0) {
-        return result;
-      }
-      result = sceKernelMapDirectMemory(addr, size, 0x33, flags, phys_addr, 0);
-      if (result < 0) {
-        sceKernelReleaseDirectMemory(phys_addr, size);
-      }
-      return result;
-    }
-    if (fd != -1) {
-      // Can't GPU map files.
-      prot &= 0x3;
-    }
-    if ((flags & 0x100) == 1) {
-      // Reserved memory has no protection, mmap just ignores prot.
-      prot = 0;
-    }
-    return sceKernelMmap(*addr, size, prot, flags, fd, offset, addr);
-  };
-
-  auto unmap_func = [](uint64_t addr, uint64_t size) __attribute__((optnone)) {
-    // We can use a VirtualQuery to see if this is direct or not
-    struct OrbisKernelVirtualQueryInfo {
-      uint64_t start;
-      uint64_t end;
-      int64_t  offset;
-      int32_t  prot;
-      int32_t  memory_type;
-      uint8_t  is_flexible  : 1;
-      uint8_t  is_direct    : 1;
-      uint8_t  is_stack     : 1;
-      uint8_t  is_pooled    : 1;
-      uint8_t  is_committed : 1;
-      char     name[32];
-    };
-    OrbisKernelVirtualQueryInfo info;
-    info           = {};
-    int32_t result = sceKernelVirtualQuery(addr, 0, &info, sizeof(info));
-    if (info.is_direct == 1) {
-      // Just release the direct memory, which will unmap for us.
-      int64_t offset = (addr - info.start) + info.offset;
-      result         = sceKernelReleaseDirectMemory(offset, size);
-    } else {
-      result = sceKernelMunmap(addr, size);
-    }
-    return result;
-  };
 
   // Test memory coalescing behaviors.
   // For safety, start by reserving a 0xa0000 sized chunk of virtual memory
@@ -2680,19 +2555,19 @@ TEST(MemoryTests, CoalescingTest) {
 
   // To test coalescing in it's fullest, we'll map outside-in
   uint64_t base_addr = addr;
-  result             = map_func(&addr, 0x20000, -1, 0, 0x1010);
+  result             = intest_map(&addr, 0x20000, -1, 0, 0x1010);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x80000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x1010);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x1010);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x20000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x1010);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x1010);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x60000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x1010);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x1010);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -2722,7 +2597,7 @@ TEST(MemoryTests, CoalescingTest) {
 
   // Test making a mapping in between these other mappings.
   addr   = base_addr + 0x40000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x1010);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x1010);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -2850,26 +2725,26 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0xa0000, end_addr);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0xa0000);
+  result = intest_unmap(base_addr, 0xa0000);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
 
   // Perform memory reservations instead.
   addr   = base_addr;
-  result = map_func(&addr, 0x20000, -1, 0, 0x111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x111);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x80000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x111);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x20000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x111);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x60000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x111);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -2877,20 +2752,6 @@ TEST(MemoryTests, CoalescingTest) {
   // Check the state of the vmem areas.
   // Reserved areas coalesce normally.
   // sceKernelQueryMemoryProtection returns errors with reserved memory, use sceKernelVirtualQuery instead.
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   OrbisKernelVirtualQueryInfo info;
   info   = {};
   result = sceKernelVirtualQuery(base_addr, 0, &info, sizeof(info));
@@ -2906,7 +2767,7 @@ TEST(MemoryTests, CoalescingTest) {
 
   // Test making a mapping in between these other mappings.
   addr   = base_addr + 0x40000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x111);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -2919,26 +2780,26 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0xa0000, info.end);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0xa0000);
+  result = intest_unmap(base_addr, 0xa0000);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
 
   // Perform memory reservations without MAP_SHARED. This appears to skip some coalescing logic?
   addr   = base_addr;
-  result = map_func(&addr, 0x20000, -1, 0, 0x110);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x110);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x80000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x110);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x110);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x20000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x110);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x110);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x60000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x110);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x110);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -2959,7 +2820,7 @@ TEST(MemoryTests, CoalescingTest) {
 
   // Test making a mapping in between these other mappings.
   addr   = base_addr + 0x40000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x110);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x110);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -2978,7 +2839,7 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0xa0000, info.end);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0xa0000);
+  result = intest_unmap(base_addr, 0xa0000);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -2986,19 +2847,19 @@ TEST(MemoryTests, CoalescingTest) {
   // Now test with direct memory.
   // With SDK version 1.00, this will not coalesce.
   addr   = base_addr;
-  result = map_func(&addr, 0x20000, -1, 0x100000, 0x10);
+  result = intest_map(&addr, 0x20000, -1, 0x100000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x80000;
-  result = map_func(&addr, 0x20000, -1, 0x180000, 0x10);
+  result = intest_map(&addr, 0x20000, -1, 0x180000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x20000;
-  result = map_func(&addr, 0x20000, -1, 0x120000, 0x10);
+  result = intest_map(&addr, 0x20000, -1, 0x120000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x60000;
-  result = map_func(&addr, 0x20000, -1, 0x160000, 0x10);
+  result = intest_map(&addr, 0x20000, -1, 0x160000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3025,7 +2886,7 @@ TEST(MemoryTests, CoalescingTest) {
 
   // Test making a mapping in between these other mappings.
   addr   = base_addr + 0x40000;
-  result = map_func(&addr, 0x20000, -1, 0x140000, 0x10);
+  result = intest_map(&addr, 0x20000, -1, 0x140000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3153,7 +3014,7 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0xa0000, end_addr);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0xa0000);
+  result = intest_unmap(base_addr, 0xa0000);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3168,19 +3029,19 @@ TEST(MemoryTests, CoalescingTest) {
   // file mmaps coalesce so long as MAP_SHARED is provided. Otherwise, they remain separate.
   // Start by testing without MAP_SHARED.
   addr   = base_addr;
-  result = map_func(&addr, 0x4000, fd, 0x20000, 0x10);
+  result = intest_map(&addr, 0x4000, fd, 0x20000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x10000;
-  result = map_func(&addr, 0x4000, fd, 0x30000, 0x10);
+  result = intest_map(&addr, 0x4000, fd, 0x30000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x4000;
-  result = map_func(&addr, 0x4000, fd, 0x24000, 0x10);
+  result = intest_map(&addr, 0x4000, fd, 0x24000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0xc000;
-  result = map_func(&addr, 0x4000, fd, 0x2c000, 0x10);
+  result = intest_map(&addr, 0x4000, fd, 0x2c000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3207,7 +3068,7 @@ TEST(MemoryTests, CoalescingTest) {
 
   // Test making a mapping in between these other mappings.
   addr   = base_addr + 0x8000;
-  result = map_func(&addr, 0x4000, fd, 0x28000, 0x10);
+  result = intest_map(&addr, 0x4000, fd, 0x28000, 0x10);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3335,7 +3196,7 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0x14000, end_addr);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0x14000);
+  result = intest_unmap(base_addr, 0x14000);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3343,19 +3204,19 @@ TEST(MemoryTests, CoalescingTest) {
   // file mmaps coalesce so long as MAP_SHARED is provided. Otherwise, they remain separate.
   // Test with MAP_SHARED here.
   addr   = base_addr;
-  result = map_func(&addr, 0x4000, fd, 0x20000, 0x11);
+  result = intest_map(&addr, 0x4000, fd, 0x20000, 0x11);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x10000;
-  result = map_func(&addr, 0x4000, fd, 0x30000, 0x11);
+  result = intest_map(&addr, 0x4000, fd, 0x30000, 0x11);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x4000;
-  result = map_func(&addr, 0x4000, fd, 0x24000, 0x11);
+  result = intest_map(&addr, 0x4000, fd, 0x24000, 0x11);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0xc000;
-  result = map_func(&addr, 0x4000, fd, 0x2c000, 0x11);
+  result = intest_map(&addr, 0x4000, fd, 0x2c000, 0x11);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3372,7 +3233,7 @@ TEST(MemoryTests, CoalescingTest) {
 
   // Test making a mapping in between these other mappings.
   addr   = base_addr + 0x8000;
-  result = map_func(&addr, 0x4000, fd, 0x28000, 0x11);
+  result = intest_map(&addr, 0x4000, fd, 0x28000, 0x11);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3384,7 +3245,7 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0x14000, end_addr);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0x14000);
+  result = intest_unmap(base_addr, 0x14000);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3392,19 +3253,19 @@ TEST(MemoryTests, CoalescingTest) {
   // Check behavior for read-only file mmaps without MAP_SHARED
   // This case also merges, like how MAP_SHARED behaves.
   addr   = base_addr;
-  result = map_func(&addr, 0x4000, fd, 0x20000, 0x10, 0x1);
+  result = intest_map(&addr, 0x4000, fd, 0x20000, 0x10, 0x1);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x10000;
-  result = map_func(&addr, 0x4000, fd, 0x30000, 0x10, 0x1);
+  result = intest_map(&addr, 0x4000, fd, 0x30000, 0x10, 0x1);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x4000;
-  result = map_func(&addr, 0x4000, fd, 0x24000, 0x10, 0x1);
+  result = intest_map(&addr, 0x4000, fd, 0x24000, 0x10, 0x1);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0xc000;
-  result = map_func(&addr, 0x4000, fd, 0x2c000, 0x10, 0x1);
+  result = intest_map(&addr, 0x4000, fd, 0x2c000, 0x10, 0x1);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3421,7 +3282,7 @@ TEST(MemoryTests, CoalescingTest) {
 
   // Test making a mapping in between these other mappings.
   addr   = base_addr + 0x8000;
-  result = map_func(&addr, 0x4000, fd, 0x28000, 0x10, 0x1);
+  result = intest_map(&addr, 0x4000, fd, 0x28000, 0x10, 0x1);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3433,7 +3294,7 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0x14000, end_addr);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0x14000);
+  result = intest_unmap(base_addr, 0x14000);
   UNSIGNED_INT_EQUALS(0, result);
 
   sceKernelClose(fd);
@@ -3441,19 +3302,19 @@ TEST(MemoryTests, CoalescingTest) {
   // Now test the NoCoalesce (0x400000) flag
   // With this, even reserved memory will not coalesce.
   addr   = base_addr;
-  result = map_func(&addr, 0x20000, -1, 0, 0x400111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x400111);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x80000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x400111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x400111);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x20000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x400111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x400111);
   UNSIGNED_INT_EQUALS(0, result);
 
   addr   = base_addr + 0x60000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x400111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x400111);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3487,7 +3348,7 @@ TEST(MemoryTests, CoalescingTest) {
   // Test making a mapping in between these other mappings.
   // Omit the NoCoalesce flag, this still shouldn't coalesce due to the surrounding areas.
   addr   = base_addr + 0x40000;
-  result = map_func(&addr, 0x20000, -1, 0, 0x111);
+  result = intest_map(&addr, 0x20000, -1, 0, 0x111);
   UNSIGNED_INT_EQUALS(0, result);
 
   mem_scan();
@@ -3561,7 +3422,7 @@ TEST(MemoryTests, CoalescingTest) {
   LONGS_EQUAL(base_addr + 0xa0000, info.end);
 
   // Unmap testing memory.
-  result = unmap_func(base_addr, 0xa0000);
+  result = intest_unmap(base_addr, 0xa0000);
   UNSIGNED_INT_EQUALS(0, result);
 }
 
@@ -3596,20 +3457,6 @@ TEST(MemoryTests, ProtectTest) {
 
   // For simplicity, use sceKernelVirtualQuery to validate prot.
   // While not necessary for most mappings, some tests will need it.
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   // Verify the lack of protection.
   OrbisKernelVirtualQueryInfo info = {};
   result                           = sceKernelVirtualQuery(addr, 0, &info, sizeof(info));
@@ -4090,20 +3937,6 @@ TEST(MemoryTests, TypeProtectTest) {
   UNSIGNED_INT_EQUALS(0, result);
   LONGS_EQUAL(vmem_start + 0x100000, addr);
 
-  struct OrbisKernelVirtualQueryInfo {
-    uint64_t start;
-    uint64_t end;
-    int64_t  offset;
-    int32_t  prot;
-    int32_t  memory_type;
-    uint8_t  is_flexible  : 1;
-    uint8_t  is_direct    : 1;
-    uint8_t  is_stack     : 1;
-    uint8_t  is_pooled    : 1;
-    uint8_t  is_committed : 1;
-    char     name[32];
-  };
-
   // Verify the lack of protection.
   OrbisKernelVirtualQueryInfo info = {};
   result                           = sceKernelVirtualQuery(addr, 0, &info, sizeof(info));
@@ -6,7 +6,7 @@
 TEST_GROUP (MemoryTests) {
   void setup() { // Before each test, call mem_scan to print out memory map information.
     // This will provide an indicator of how the memory map looks, which can help with debugging strange behavior during tests.
-    printf("Before test:\n");
+    intest_printf("Before test:\n");
     mem_scan();
   }
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Benchmark results are printed one per line, prefixed with "[bench]" so they can be filtered out of the regular test log:
+// [bench] <suite>/<case> key=value key=value ...
+// Latencies are always reported in nanoseconds, sizes in bytes.
+
+static inline uint64_t bench_ticks() {
+  return sceKernelReadTsc();
+}
+
+static inline double bench_ticks_to_ns(uint64_t ticks) {
+  static const double ns_per_tick = 1000000000.0 / double(sceKernelGetTscFrequency());
+  return double(ticks) * ns_per_tick;
+}
+
+// Formats a byte count as 16K/4M/1G for case names.
+static inline const char* bench_size_str(uint64_t size, char* buf, size_t buf_size) {
+  if (size >= 0x40000000 && (size % 0x40000000) == 0) {
+    snprintf(buf, buf_size, "%lluG", (unsigned long long)(size >> 30));
+  } else if (size >= 0x100000 && (size % 0x100000) == 0) {
+    snprintf(buf, buf_size, "%lluM", (unsigned long long)(size >> 20));
+  } else {
+    snprintf(buf, buf_size, "%lluK", (unsigned long long)(size >> 10));
+  }
+  return buf;
+}
+
+// Collects per-call latencies in TSC ticks and reports throughput and percentiles.
+struct LatencyStats {
+  std::vector<uint64_t> samples;
+  uint64_t              total  = 0;
+  bool                  sorted = true;
+
+  explicit LatencyStats(size_t expected = 0) { samples.reserve(expected); }
+
+  void add(uint64_t ticks) {
+    samples.push_back(ticks);
+    total += ticks;
+    sorted = false;
+  }
+
+  void merge(const LatencyStats& other) {
+    samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+    total += other.total;
+    sorted = samples.empty();
+  }
+
+  void clear() {
+    samples.clear();
+    total  = 0;
+    sorted = true;
+  }
+
+  size_t count() const { return samples.size(); }
+
+  double mean_ns() const { return samples.empty() ? 0.0 : bench_ticks_to_ns(total) / double(samples.size()); }
+
+  double calls_per_sec() const { return total == 0 ? 0.0 : double(samples.size()) * 1000000000.0 / bench_ticks_to_ns(total); }
+
+  // Nearest-rank percentile, p in [0, 1].
+  double percentile_ns(double p) {
+    if (samples.empty()) return 0.0;
+    if (!sorted) {
+      std::sort(samples.begin(), samples.end());
+      sorted = true;
+    }
+    size_t rank = size_t(p * double(samples.size()) + 0.999999);
+    rank        = std::clamp<size_t>(rank, 1, samples.size());
+    return bench_ticks_to_ns(samples[rank - 1]);
+  }
+
+  void report(const char* suite, const char* name) {
+    intest_printf("[bench] %s/%s n=%zu calls_per_sec=%.0f mean_ns=%.0f p50_ns=%.0f p99_ns=%.0f p999_ns=%.0f max_ns=%.0f\n", suite, name, count(),
+                  calls_per_sec(), mean_ns(), percentile_ns(0.5), percentile_ns(0.99), percentile_ns(0.999), percentile_ns(1.0));
+  }
+};
@@ -0,0 +1,194 @@
+#include "junit_output.h"
+
+#include "kernel.h"
+#include "runner.h"
+
+#include <CppUTest/TestHarness.h>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+// Per-test capture of what a test prints through intest_printf() and CppUTest (UT_PRINT and the like). The buffer is static
+// so capturing never allocates while CppUTest leak detection is active, output past its end is dropped and the test case
+// is marked as truncated. Only the test thread appends. The watchdog thread reads it in abort() while that thread is stuck, it
+// turns the capture off first and only reads up to the size published before.
+static char                junit_capture[0x10000];
+static std::atomic<size_t> junit_capture_size      = 0;
+static std::atomic<bool>   junit_capture_enabled   = false;
+static bool                junit_capture_truncated = false;
+
+static void junit_capture_append(const char* data, size_t size) {
+  size_t used  = junit_capture_size.load();
+  size_t space = sizeof(junit_capture) - used;
+  if (size > space) {
+    size                    = space;
+    junit_capture_truncated = true;
+  }
+  memcpy(junit_capture + used, data, size);
+  junit_capture_size.store(used + size);
+}
+
+int intest_printf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  if (junit_capture_enabled) {
+    // Formatted straight into the capture buffer, vsnprintf always terminates, so the last byte is never kept.
+    va_list capture_args;
+    va_copy(capture_args, args);
+    size_t used  = junit_capture_size.load();
+    size_t space = sizeof(junit_capture) - used;
+    int    size  = vsnprintf(junit_capture + used, space, format, capture_args);
+    va_end(capture_args);
+    if (size > 0) {
+      if (size_t(size) >= space) {
+        size                    = space > 0 ? int(space - 1) : 0;
+        junit_capture_truncated = true;
+      }
+      junit_capture_size.store(used + size_t(size));
+    }
+  }
+  int result = vprintf(format, args);
+  va_end(args);
+  return result;
+}
+
+static void junit_append_escaped(std::string& out, const char* str, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    char c = str[i];
+    switch (c) {
+      case '&': out += "&amp;"; break;
+      case '<': out += "&lt;"; break;
+      case '>': out += "&gt;"; break;
+      case '"': out += "&quot;"; break;
+      case '\'': out += "&apos;"; break;
+      default:
+        // XML 1.0 can't carry most control characters, not even escaped.
+        out += (uint8_t(c) < 0x20 && c != '\n' && c != '\r' && c != '\t') ? '?' : c;
+        break;
+    }
+  }
+}
+
+static void junit_append_escaped(std::string& out, const std::string& str) {
+  junit_append_escaped(out, str.data(), str.size());
+}
+
+static void junit_append_seconds(std::string& out, uint64_t ticks) {
+  char seconds[32];
+  snprintf(seconds, sizeof(seconds), "%.3f", double(ticks) / double(sceKernelGetTscFrequency()));
+  out += seconds;
+}
+
+JUnitOutput::JUnitOutput(const char* path): path(path) {}
+
+JUnitOutput::~JUnitOutput() {
+  junit_capture_enabled = false;
+}
+
+void JUnitOutput::printTestsStarted() {
+  cases.clear();
+  run_start = sceKernelReadTsc();
+}
+
+void JUnitOutput::printCurrentTestStarted(const UtestShell& test) {
+  current.group   = test.getGroup().asCharString();
+  current.name    = test.getName().asCharString();
+  current.file    = test.getFile().asCharString();
+  current.line    = test.getLineNumber();
+  current.skipped = !test.willRun();
+  current.failures.clear();
+  current.output.clear();
+
+  junit_capture_size      = 0;
+  junit_capture_truncated = false;
+  junit_capture_enabled   = true;
+  test_start              = sceKernelReadTsc();
+}
+
+void JUnitOutput::printBuffer(const char* buffer) {
+  if (junit_capture_enabled) junit_capture_append(buffer, strlen(buffer));
+}
+
+void JUnitOutput::printFailure(const TestFailure& failure) {
+  add_failure(failure.getFileName().asCharString(), failure.getFailureLineNumber(), failure.getMessage().asCharString(), failure.getMessage().size());
+}
+
+void JUnitOutput::add_failure(const char* file, size_t line, const char* message, size_t message_size) {
+  char line_str[32];
+  snprintf(line_str, sizeof(line_str), ":%zu: ", line);
+  std::string location = std::string(file) + line_str;
+
+  current.failures += "<failure message=\"";
+  junit_append_escaped(current.failures, location);
+  junit_append_escaped(current.failures, message, message_size);
+  current.failures += "\" type=\"AssertionFailedError\"/>\n";
+}
+
+void JUnitOutput::printCurrentTestEnded(const TestResult& result) {
+  end_current_case();
+}
+
+void JUnitOutput::end_current_case() {
+  current.ticks         = sceKernelReadTsc() - test_start;
+  junit_capture_enabled = false;
+  current.output.assign(junit_capture, junit_capture_size.load());
+  if (junit_capture_truncated) current.output += "\n[output truncated]\n";
+  cases.push_back(current);
+}
+
+void JUnitOutput::printTestsEnded(const TestResult& result) {
+  write(sceKernelReadTsc() - run_start);
+}
+
+void JUnitOutput::abort(const char* file, int line, const char* message) {
+  if (junit_capture_enabled.exchange(false)) {
+    add_failure(file != nullptr ? file : current.file.c_str(), file != nullptr ? size_t(line) : current.line, message, strlen(message));
+    end_current_case();
+  }
+  write(sceKernelReadTsc() - run_start);
+}
+
+void JUnitOutput::write(uint64_t total_ticks) {
+  // A test with several failed checks is still one failed test case.
+  size_t      skipped = 0;
+  size_t      failed  = 0;
+  std::string xml;
+  char        counts[128];
+  for (const TestCase& test_case: cases) {
+    if (test_case.skipped) ++skipped;
+    if (!test_case.failures.empty()) ++failed;
+  }
+
+  xml += "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<testsuites>\n";
+  snprintf(counts, sizeof(counts), "<testsuite errors=\"0\" failures=\"%zu\" skipped=\"%zu\" tests=\"%zu\" name=\"", failed, skipped, cases.size());
+  xml += counts;
+  xml += intest_title_id;
+  xml += "\" time=\"";
+  junit_append_seconds(xml, total_ticks);
+  xml += "\">\n";
+
+  for (const TestCase& test_case: cases) {
+    snprintf(counts, sizeof(counts), "\" line=\"%zu\" time=\"", test_case.line);
+    xml += "<testcase classname=\"";
+    junit_append_escaped(xml, test_case.group);
+    xml += "\" name=\"";
+    junit_append_escaped(xml, test_case.name);
+    xml += "\" file=\"";
+    junit_append_escaped(xml, test_case.file);
+    xml += counts;
+    junit_append_seconds(xml, test_case.ticks);
+    xml += "\">\n";
+    if (test_case.skipped) xml += "<skipped/>\n";
+    xml += test_case.failures;
+    if (!test_case.output.empty()) {
+      xml += "<system-out>";
+      junit_append_escaped(xml, test_case.output);
+      xml += "</system-out>\n";
+    }
+    xml += "</testcase>\n";
+  }
+  xml += "</testsuite>\n</testsuites>\n";
+
+  if (intest_write_file(path.c_str(), xml)) printf("JUnit results written to %s\n", path.c_str());
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <CppUTest/TestOutput.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Collects test results and writes them as a single JUnit XML file once all tests ran.
+// Every test case gets its duration, its failures with file and line, and everything the test printed with intest_printf()
+// (see runner.h) or through CppUTest (UT_PRINT) while it ran. Plain printf output only goes to the console.
+class JUnitOutput: public TestOutput {
+public:
+  explicit JUnitOutput(const char* path);
+  ~JUnitOutput() override;
+
+  void printTestsStarted() override;
+  void printTestsEnded(const TestResult& result) override;
+  void printCurrentTestStarted(const UtestShell& test) override;
+  void printCurrentTestEnded(const TestResult& result) override;
+  void printFailure(const TestFailure& failure) override;
+
+  // Writes the results so far when the watchdog ends the run, the active test is added as a failure at file:line.
+  void abort(const char* file, int line, const char* message);
+
+  // CppUTest output while a test runs is captured for the test case, everything else goes to the console only.
+  void printBuffer(const char* buffer) override;
+
+  void flush() override {}
+
+private:
+  struct TestCase {
+    std::string group;
+    std::string name;
+    std::string file;
+    size_t      line;
+    uint64_t    ticks;
+    bool        skipped;
+    std::string failures;
+    std::string output;
+  };
+
+  void add_failure(const char* file, size_t line, const char* message, size_t message_size);
+  void end_current_case();
+  void write(uint64_t total_ticks);
+
+  std::string           path;
+  std::vector<TestCase> cases;
+  TestCase              current;
+  uint64_t              run_start  = 0;
+  uint64_t              test_start = 0;
+};
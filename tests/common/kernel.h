@@ -1,4 +1,6 @@
-#define UNSIGNED_INT_EQUALS(expected, actual) UNSIGNED_LONGS_EQUAL_LOCATION((uint32_t)expected, (uint32_t)actual, NULLPTR, __FILE__, __LINE__)
+#pragma once
+
+#include <cstdint>
 
 // Function definitions (with modified types to improve testability)
 extern "C" {
@@ -44,6 +46,7 @@ int32_t sceKernelMemoryPoolExpand(int64_t start, int64_t end, uint64_t len, uint
 int32_t sceKernelMemoryPoolReserve(uint64_t addr_in, uint64_t len, uint64_t alignment, int32_t flags, uint64_t* addr_out);
 int32_t sceKernelMemoryPoolCommit(uint64_t addr, uint64_t len, int32_t type, int32_t prot, int32_t flags);
 int32_t sceKernelMemoryPoolDecommit(uint64_t addr, uint64_t len, int32_t flags);
+int32_t sceKernelMemoryPoolGetBlockStats(void* stats, uint64_t stats_size);
 
 // Filesystem functions
 int32_t sceKernelOpen(const char* path, int32_t flags, uint16_t mode);
@@ -52,9 +55,21 @@ int64_t sceKernelWrite(int32_t fd, const void* buf, uint64_t size);
 int32_t sceKernelFtruncate(int32_t fd, int64_t size);
 int64_t sceKernelLseek(int32_t fd, int64_t offset, int32_t whence);
 int32_t sceKernelClose(int32_t fd);
+int32_t sceKernelUnlink(const char* path);
 
 // System functions
 const char* sceKernelGetFsSandboxRandomWord();
+uint64_t    sceKernelGetProcessTime();
+
+// Timing functions
+uint64_t sceKernelGetTscFrequency();
+uint64_t sceKernelReadTsc();
+int32_t  sceKernelUsleep(uint32_t microseconds);
+
+// Thread functions
+int32_t scePthreadCreate(void** thread, const void* attr, void* (*entry)(void*), void* arg, const char* name);
+int32_t scePthreadJoin(void* thread, void** value);
+void    scePthreadYield();
 }
 
 // Some error codes
@@ -161,59 +176,26 @@ enum OrbisError : int32_t {
   ORBIS_KERNEL_ERROR_ENOPLAYGOENT    = int(0x80020061)
 };
 
-#define mem_scan() _mem_scan(__FILE__, __LINE__)
-
-static inline void _mem_scan(const char* file, int line) {
-  // Helper method from red_prig for printing out memory map information.
-  const char* _F = "_F";
-  const char* _D = "_D";
-  const char* _S = "_S";
-  const char* _P = "_P";
-  const char* _C = "_C";
-  const char* _R = "_R";
-  const char* _W = "_W";
-  const char* _X = "_X";
-
-  struct OrbisKernelVirtualQueryInfo {
-    unsigned long long start_addr;
-    unsigned long long end_addr;
-    unsigned long long offset;
-    int32_t            prot;
-    int32_t            mtype;
-    uint8_t            isFlexibleMemory : 1;
-    uint8_t            isDirectMemory   : 1;
-    uint8_t            isStack          : 1;
-    uint8_t            isPooledMemory   : 1;
-    uint8_t            isCommitted      : 1;
-    char               name[32];
-  };
-
-  printf("mem_scan[%s:%d]\n", file, line);
+// Output of sceKernelVirtualQuery. Shared by all packages, don't declare local copies.
+struct OrbisKernelVirtualQueryInfo {
+  uint64_t start;
+  uint64_t end;
+  int64_t  offset;
+  int32_t  prot;
+  int32_t  memory_type;
+  uint8_t  is_flexible  : 1;
+  uint8_t  is_direct    : 1;
+  uint8_t  is_stack     : 1;
+  uint8_t  is_pooled    : 1;
+  uint8_t  is_committed : 1;
+  char     name[32];
+};
+static_assert(sizeof(OrbisKernelVirtualQueryInfo) == 72, "sceKernelVirtualQuery writes 72 bytes");
 
-  uint64_t addr = {};
-  int      ret  = {};
-  while (true) {
-    OrbisKernelVirtualQueryInfo info = {};
-    ret                              = sceKernelVirtualQuery(addr, 1, &info, sizeof(info));
-    if (ret != 0) break;
-    addr = static_cast<uint64_t>(info.end_addr);
-    printf("0x%012llX" // start_addr
-           "-"
-           "0x%012llX" // end_addr
-           "|"
-           "0x%016llX" // offset
-           "|"
-           "%c%c%c%c%c%c" // RWXCRW
-           "|"
-           "0x%01X" // mtype
-           "|"
-           "%c%c%c%c%c" // FDSPC
-           "|"
-           "%s" // name
-           "\n",
-           info.start_addr, info.end_addr, info.offset, _R[(info.prot >> 0) & 1], _W[(info.prot >> 1) & 1], _X[(info.prot >> 2) & 1], _C[(info.prot >> 3) & 1],
-           _R[(info.prot >> 4) & 1], _W[(info.prot >> 5) & 1], info.mtype, _F[info.isFlexibleMemory], _D[info.isDirectMemory], _S[info.isStack],
-           _P[info.isPooledMemory], _C[info.isCommitted], info.name);
-  }
-  printf("\n");
-}
+// Output of sceKernelMemoryPoolGetBlockStats, counts are in 64KB blocks
+struct OrbisKernelMemoryPoolBlockStats {
+  int32_t available_flushed_blocks;
+  int32_t available_cached_blocks;
+  int32_t allocated_flushed_blocks;
+  int32_t allocated_cached_blocks;
+};
@@ -0,0 +1,11 @@
+#include "runner.h"
+
+#include <orbis/SystemService.h>
+
+// Linked into every package from the intest library. Test groups are compiled into the package itself,
+// so they register without IMPORT_TEST_GROUP. Packages with their own main() never pull this one in.
+int main(int ac, char** av) {
+  int result = intest_run_all_tests(ac, av);
+  sceSystemServiceLoadExec("EXIT", nullptr);
+  return result;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// Map/unmap wrappers for tests that depend on how areas coalesce.
+// Firmwares below 5.50 only merge areas that were mapped from the same calling address, these are out of line and
+// built with optnone so every mapping made through them comes from one static address.
+
+// Effectively an mmap wrapper. fd == -1 with a non-zero offset allocates direct memory at that offset and maps it instead.
+// File mappings drop the GPU bits of prot.
+int32_t intest_map(uint64_t* addr, uint64_t size, int32_t fd, uint64_t offset, int32_t flags, int32_t prot = 0x33);
+
+// Unmaps anonymous and file mappings, direct memory mappings are released instead, which also unmaps them.
+int32_t intest_unmap(uint64_t addr, uint64_t size);
@@ -0,0 +1,176 @@
+#include "mem_scan.h"
+
+#include "kernel.h"
+#include "runner.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Snapshots live in static storage, mem_scan() runs inside tests and must not allocate while CppUTest checks for leaks.
+static MemScanInfo mem_scan_snapshots[2][mem_scan_capacity];
+static size_t      mem_scan_counts[2] = {};
+static int32_t     mem_scan_current   = 0;
+static bool        mem_scan_have_prev = false;
+static int32_t     mem_scan_blob_fd   = -1;
+static MemScanMode mem_scan_mode      = MemScanMode::Full;
+
+bool intest_parse_mem_scan_mode(const char* name, MemScanMode* mode) {
+  if (strcmp(name, "full") == 0) {
+    *mode = MemScanMode::Full;
+  } else if (strcmp(name, "diff") == 0) {
+    *mode = MemScanMode::Diff;
+  } else if (strcmp(name, "binary") == 0) {
+    *mode = MemScanMode::Binary;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void intest_set_mem_scan_mode(MemScanMode mode) {
+  mem_scan_mode      = mode;
+  mem_scan_have_prev = false;
+}
+
+void intest_print_memory_area(char prefix, const MemScanInfo& info) {
+  // Helper method from red_prig for printing out memory map information.
+  const char* _F = "_F";
+  const char* _D = "_D";
+  const char* _S = "_S";
+  const char* _P = "_P";
+  const char* _C = "_C";
+  const char* _R = "_R";
+  const char* _W = "_W";
+  const char* _X = "_X";
+
+  if (prefix != '\0') intest_printf("%c", prefix);
+  intest_printf("0x%012llX" // start
+                "-"
+                "0x%012llX" // end
+                "|"
+                "0x%016llX" // offset
+                "|"
+                "%c%c%c%c%c%c" // RWXCRW
+                "|"
+                "0x%01X" // memory_type
+                "|"
+                "%c%c%c%c%c" // FDSPC
+                "|"
+                "%s" // name
+                "\n",
+                (unsigned long long)info.start, (unsigned long long)info.end, (unsigned long long)info.offset, _R[(info.prot >> 0) & 1],
+                _W[(info.prot >> 1) & 1], _X[(info.prot >> 2) & 1], _C[(info.prot >> 3) & 1], _R[(info.prot >> 4) & 1], _W[(info.prot >> 5) & 1],
+                info.memory_type, _F[info.is_flexible], _D[info.is_direct], _S[info.is_stack], _P[info.is_pooled], _C[info.is_committed], info.name);
+}
+
+size_t intest_capture_memory_map(MemScanInfo* out, size_t capacity) {
+  size_t   count = 0;
+  uint64_t addr  = 0;
+  while (true) {
+    MemScanInfo info = {};
+    if (sceKernelVirtualQuery(addr, 1, &info, sizeof(info)) != 0) break;
+    addr = info.end;
+    if (count == capacity) return SIZE_MAX;
+    out[count++] = info;
+  }
+  return count;
+}
+
+MemScanDiff intest_diff_memory_maps(const MemScanInfo* prev, size_t prev_count, const MemScanInfo* curr, size_t curr_count, bool print) {
+  MemScanDiff diff = {};
+  size_t      p    = 0;
+  size_t      c    = 0;
+
+  auto removed = [&](const MemScanInfo& info) {
+    if (print) intest_print_memory_area('-', info);
+    diff.removed++;
+    diff.bytes -= int64_t(info.end - info.start);
+  };
+  auto added = [&](const MemScanInfo& info) {
+    if (print) intest_print_memory_area('+', info);
+    diff.added++;
+    diff.bytes += int64_t(info.end - info.start);
+  };
+
+  // Both maps are sorted by address, walk them together. An area that changed counts as removed and added again.
+  while (p < prev_count || c < curr_count) {
+    if (c == curr_count || (p < prev_count && prev[p].start < curr[c].start)) {
+      removed(prev[p++]);
+    } else if (p == prev_count || curr[c].start < prev[p].start) {
+      added(curr[c++]);
+    } else {
+      if (memcmp(&prev[p], &curr[c], sizeof(MemScanInfo)) != 0) {
+        removed(prev[p]);
+        added(curr[c]);
+      }
+      ++p;
+      ++c;
+    }
+  }
+  return diff;
+}
+
+static void mem_scan_write_blob(const char* file, int line) {
+  if (mem_scan_blob_fd < 0) {
+    // 0x602 = O_RDWR | O_CREAT | O_TRUNC, the file is kept open and appended to for the rest of the run.
+    char path[64];
+    snprintf(path, sizeof(path), "/data/%s_mem_scan.bin", intest_title_id);
+    mem_scan_blob_fd = sceKernelOpen(path, 0x602, 0666);
+    if (mem_scan_blob_fd < 0) {
+      intest_printf("mem_scan: failed to open %s: 0x%08x\n", path, mem_scan_blob_fd);
+      return;
+    }
+  }
+
+  MemScanBlobHeader header = {};
+  header.magic             = 0x4E43534D;
+  header.line              = uint32_t(line);
+  header.count             = uint32_t(mem_scan_counts[mem_scan_current]);
+  header.record_size       = sizeof(MemScanInfo);
+  header.file_size         = uint32_t(strlen(file));
+  sceKernelWrite(mem_scan_blob_fd, &header, sizeof(header));
+  sceKernelWrite(mem_scan_blob_fd, file, header.file_size);
+  sceKernelWrite(mem_scan_blob_fd, mem_scan_snapshots[mem_scan_current], header.count * sizeof(MemScanInfo));
+}
+
+void intest_mem_scan(const char* file, int line) {
+  intest_printf("mem_scan[%s:%d]\n", file, line);
+
+  if (mem_scan_mode == MemScanMode::Full) {
+    uint64_t addr = 0;
+    while (true) {
+      MemScanInfo info = {};
+      if (sceKernelVirtualQuery(addr, 1, &info, sizeof(info)) != 0) break;
+      addr = info.end;
+      intest_print_memory_area('\0', info);
+    }
+    intest_printf("\n");
+    return;
+  }
+
+  mem_scan_current ^= 1;
+  mem_scan_counts[mem_scan_current] = intest_capture_memory_map(mem_scan_snapshots[mem_scan_current], mem_scan_capacity);
+  if (mem_scan_counts[mem_scan_current] == SIZE_MAX) {
+    // More areas than the snapshot holds, this dump can't be compared against.
+    intest_printf("mem_scan: more than %zu areas, snapshot skipped\n\n", mem_scan_capacity);
+    mem_scan_have_prev = false;
+    return;
+  }
+
+  if (mem_scan_mode == MemScanMode::Binary) {
+    mem_scan_write_blob(file, line);
+    intest_printf("%zu areas\n", mem_scan_counts[mem_scan_current]);
+  } else if (!mem_scan_have_prev) {
+    for (size_t i = 0; i < mem_scan_counts[mem_scan_current]; ++i) {
+      intest_print_memory_area('\0', mem_scan_snapshots[mem_scan_current][i]);
+    }
+  } else {
+    const int32_t prev = mem_scan_current ^ 1;
+    MemScanDiff   diff = intest_diff_memory_maps(mem_scan_snapshots[prev], mem_scan_counts[prev], mem_scan_snapshots[mem_scan_current],
+                                                 mem_scan_counts[mem_scan_current], true);
+    intest_printf("%zu areas, %zu added, %zu removed\n", mem_scan_counts[mem_scan_current], diff.added, diff.removed);
+  }
+  mem_scan_have_prev = true;
+  intest_printf("\n");
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "kernel.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Memory map dumps used by mem_scan() in the tests.
+// Full:   prints every area as text, the original behavior.
+// Diff:   prints every area on the first call, then only the areas that were added (+) or removed (-) since the previous call.
+// Binary: appends the raw records to /data/<title id>_mem_scan.bin and only prints the number of areas.
+//         Each dump is a MemScanBlobHeader with the file name right after it, followed by `count` MemScanInfo records.
+enum class MemScanMode { Full, Diff, Binary };
+
+// One sceKernelVirtualQuery record, the blob stores these as-is.
+using MemScanInfo = OrbisKernelVirtualQueryInfo;
+
+struct MemScanBlobHeader {
+  uint32_t magic; // "MSCN"
+  uint32_t line;
+  uint32_t count;
+  uint32_t record_size;
+  uint32_t file_size;
+};
+
+// Number of records the static snapshots hold, maps with more areas than this are not captured.
+static const size_t mem_scan_capacity = 4096;
+
+struct MemScanDiff {
+  size_t  added;
+  size_t  removed;
+  int64_t bytes; // Size of the added areas minus the size of the removed ones
+};
+
+// Parses full/diff/binary, returns false for anything else.
+bool intest_parse_mem_scan_mode(const char* name, MemScanMode* mode);
+void intest_set_mem_scan_mode(MemScanMode mode);
+void intest_mem_scan(const char* file, int line);
+
+// Building blocks shared with VmaLeakPlugin.
+// Captures the memory map into `out`, returns SIZE_MAX if it has more than `capacity` areas.
+size_t      intest_capture_memory_map(MemScanInfo* out, size_t capacity);
+void        intest_print_memory_area(char prefix, const MemScanInfo& info);
+MemScanDiff intest_diff_memory_maps(const MemScanInfo* prev, size_t prev_count, const MemScanInfo* curr, size_t curr_count, bool print);
@@ -0,0 +1,230 @@
+#include "runner.h"
+
+#include "junit_output.h"
+#include "kernel.h"
+#include "mem_scan.h"
+#include "timing_plugin.h"
+#include "vma_leak_plugin.h"
+#include "watchdog.h"
+
+#include <CppUTest/CommandLineArguments.h>
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/MemoryLeakWarningPlugin.h>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Default watchdog limits in seconds, generous enough for the slowest benchmarks on an emulator.
+static const uint32_t runner_test_timeout  = 600;
+static const uint32_t runner_total_timeout = 3600;
+
+// Results that the watchdog writes out when it ends a run early.
+static TimingPlugin* runner_timing = nullptr;
+static JUnitOutput*  runner_junit  = nullptr;
+
+class IntestTestRunner: public CommandLineTestRunner {
+public:
+  IntestTestRunner(int ac, const char* const* av, const char* junit_path)
+      : CommandLineTestRunner(ac, av, TestRegistry::getCurrentRegistry()), junit_path(junit_path) {}
+
+protected:
+  TestOutput* createConsoleOutput() override {
+    TestOutput* console = CommandLineTestRunner::createConsoleOutput();
+    if (junit_path == nullptr) return console;
+    runner_junit = new JUnitOutput(junit_path);
+    return createCompositeOutput(console, runner_junit);
+  }
+
+private:
+  const char* junit_path;
+};
+
+static void runner_timeout(const UtestShell* test, const char* file, int line, const char* message) {
+  // The test thread is stuck, possibly in the middle of updating these. Good enough for a run that ends right after.
+  if (runner_junit != nullptr) runner_junit->abort(file, line, message);
+  if (runner_timing != nullptr) runner_timing->abort(test);
+}
+
+static const char* runner_check_output_path(const char* path) {
+  if (strncmp(path, "/data/", 6) == 0 || strncmp(path, "/download0/", 11) == 0) return path;
+  printf("intest: output path %s is not under /data or /download0, ignoring it\n", path);
+  return nullptr;
+}
+
+// Arguments from the config file, the argument list points into this for the whole run.
+static char runner_args_file[0x1000];
+
+// Reads the arguments from /data/<title id>_args.txt, or /app0/intest_args.txt when there is none.
+// Arguments are separated by whitespace, '#' starts a comment that runs to the end of the line.
+static void runner_load_args_file(std::vector<const char*>& args) {
+  char data_path[64];
+  snprintf(data_path, sizeof(data_path), "/data/%s_args.txt", intest_title_id);
+  const char* paths[] = {data_path, "/app0/intest_args.txt"};
+  for (const char* path: paths) {
+    int32_t fd = sceKernelOpen(path, 0, 0);
+    if (fd < 0) continue;
+    int64_t size = sceKernelRead(fd, runner_args_file, sizeof(runner_args_file) - 1);
+    sceKernelClose(fd);
+    if (size < 0) {
+      printf("intest: failed to read %s: 0x%08llx\n", path, (unsigned long long)size);
+      return;
+    }
+    if (size == sizeof(runner_args_file) - 1) printf("intest: %s is too large, only the first %lld bytes are used\n", path, (long long)size);
+    runner_args_file[size] = '\0';
+    printf("intest: using arguments from %s\n", path);
+
+    char* c = runner_args_file;
+    while (*c != '\0') {
+      if (*c == '#') {
+        while (*c != '\0' && *c != '\n') ++c;
+      } else if (isspace(uint8_t(*c))) {
+        ++c;
+      } else {
+        args.push_back(c);
+        while (*c != '\0' && !isspace(uint8_t(*c))) ++c;
+        if (*c != '\0') *c++ = '\0';
+      }
+    }
+    return;
+  }
+}
+
+// Keeps every count-th test, starting at index, out of the tests the filters in args select. The order doesn't change,
+// so tests that have to run last still do. The shard gets a registry of its own that replaces the current one.
+static void runner_select_shard(const std::vector<const char*>& args, uint32_t index, uint32_t count) {
+  static TestRegistry shard_registry;
+  TestRegistry*       registry = TestRegistry::getCurrentRegistry();
+
+  // Same parsing as CommandLineTestRunner, so the shards split the filtered tests evenly. If the arguments are invalid
+  // the runner prints the usage and runs nothing anyway.
+  CommandLineArguments     arguments(int(args.size()), args.data());
+  bool                     filter   = arguments.parse(registry->getFirstPlugin());
+  uint32_t                 position = 0;
+  std::vector<UtestShell*> selected;
+  for (UtestShell* test = registry->getFirstTest(); test != nullptr; test = test->getNext()) {
+    if (filter && !test->shouldRun(arguments.getGroupFilters(), arguments.getNameFilters())) continue;
+    if (position++ % count == index) selected.push_back(test);
+  }
+
+  // addTest puts the test at the front of the list.
+  for (auto test = selected.rbegin(); test != selected.rend(); ++test) {
+    shard_registry.addTest(*test);
+  }
+  registry->setCurrentRegistry(&shard_registry);
+  printf("intest: shard %u/%u runs %zu of %u tests\n", index, count, selected.size(), position);
+}
+
+int intest_run_all_tests(int ac, char** av) {
+  // No buffering
+  setvbuf(stdout, NULL, _IONBF, 0);
+
+  static char              default_junit_path[64];
+  const char*              junit_path    = intest_default_junit_path[0] != '\0' ? intest_default_junit_path : nullptr;
+  const char*              mem_scan_name = intest_default_mem_scan_mode;
+  const char*              vma_leak_name = "report";
+  const char*              shard_name    = nullptr;
+  uint32_t                 test_timeout  = runner_test_timeout;
+  uint32_t                 total_timeout = runner_total_timeout;
+  std::vector<const char*> all_args;
+  std::vector<const char*> args;
+
+  // Config file arguments go before the launch arguments, so launch arguments win where CppUTest only keeps the last one.
+  if (ac > 0) all_args.push_back(av[0]);
+  runner_load_args_file(all_args);
+  for (int i = 1; i < ac; ++i) {
+    all_args.push_back(av[i]);
+  }
+
+  for (const char* arg: all_args) {
+    if (strcmp(arg, "--junit") == 0) {
+      snprintf(default_junit_path, sizeof(default_junit_path), "/data/%s_junit.xml", intest_title_id);
+      junit_path = default_junit_path;
+    } else if (strncmp(arg, "--junit=", 8) == 0) {
+      junit_path = arg + 8;
+    } else if (strncmp(arg, "--mem-scan=", 11) == 0) {
+      mem_scan_name = arg + 11;
+    } else if (strncmp(arg, "--vma-leaks=", 12) == 0) {
+      vma_leak_name = arg + 12;
+    } else if (strncmp(arg, "--shard=", 8) == 0) {
+      shard_name = arg + 8;
+    } else if (strncmp(arg, "--test-timeout=", 15) == 0) {
+      test_timeout = uint32_t(strtoul(arg + 15, nullptr, 10));
+    } else if (strncmp(arg, "--timeout=", 10) == 0) {
+      total_timeout = uint32_t(strtoul(arg + 10, nullptr, 10));
+    } else {
+      args.push_back(arg);
+    }
+  }
+  if (junit_path != nullptr) junit_path = runner_check_output_path(junit_path);
+
+  MemScanMode mem_scan_mode = MemScanMode::Full;
+  if (!intest_parse_mem_scan_mode(mem_scan_name, &mem_scan_mode)) printf("intest: unknown mem_scan mode %s, using full\n", mem_scan_name);
+  intest_set_mem_scan_mode(mem_scan_mode);
+
+  VmaLeakPlugin::Mode vma_leak_mode = VmaLeakPlugin::Mode::Report;
+  if (!VmaLeakPlugin::parse_mode(vma_leak_name, &vma_leak_mode)) printf("intest: unknown VMA leak mode %s, using report\n", vma_leak_name);
+
+  if (shard_name != nullptr) {
+    uint32_t shard_index = 0;
+    uint32_t shard_count = 0;
+    if (sscanf(shard_name, "%u/%u", &shard_index, &shard_count) == 2 && shard_index < shard_count) {
+      runner_select_shard(args, shard_index, shard_count);
+    } else {
+      printf("intest: invalid shard %s, expected <index>/<count> with index < count, running all tests\n", shard_name);
+    }
+  }
+
+  // Same setup as CommandLineTestRunner::RunAllTests, with the runner plugins installed before the leak checker.
+  // The plugin installed first runs closest to the test, so the timing doesn't include the VMA leak check.
+  // The watchdog goes last, a hang in any of the other plugins counts against the test too.
+  TestRegistry*           registry = TestRegistry::getCurrentRegistry();
+  TimingPlugin            timing;
+  VmaLeakPlugin           vma_leaks(vma_leak_mode);
+  MemoryLeakWarningPlugin leaks(DEF_PLUGIN_MEM_LEAK);
+  WatchdogPlugin          watchdog(test_timeout, total_timeout, runner_timeout);
+  leaks.destroyGlobalDetectorAndTurnOffMemoryLeakDetectionInDestructor(true);
+  registry->installPlugin(&timing);
+  registry->installPlugin(&vma_leaks);
+  registry->installPlugin(&leaks);
+  registry->installPlugin(&watchdog);
+  runner_timing = &timing;
+
+  int result = 0;
+  {
+    IntestTestRunner runner(int(args.size()), args.data(), junit_path);
+    watchdog.start();
+    result = runner.runAllTestsMain();
+    watchdog.stop();
+    runner_junit = nullptr;
+  }
+  runner_timing = nullptr;
+  if (result == 0) {
+    ConsoleTestOutput output;
+    output << leaks.FinalReport(0);
+  }
+  registry->removePluginByName(watchdog.getName());
+  registry->removePluginByName(DEF_PLUGIN_MEM_LEAK);
+  registry->removePluginByName(vma_leaks.getName());
+  registry->removePluginByName(timing.getName());
+
+  timing.report();
+  return result;
+}
+
+bool intest_write_file(const char* path, const std::string& data) {
+  // 0x602 = O_RDWR | O_CREAT | O_TRUNC
+  int32_t fd = sceKernelOpen(path, 0x602, 0666);
+  if (fd < 0) {
+    printf("intest: failed to open %s: 0x%08x\n", path, fd);
+    return false;
+  }
+  int64_t written = sceKernelWrite(fd, data.data(), data.size());
+  sceKernelClose(fd);
+  if (written != int64_t(data.size())) {
+    printf("intest: failed to write %s: 0x%08llx\n", path, (unsigned long long)written);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Per-package settings, defined in the <title id>_info.cpp that create_pkg generates for every package.
+// Everything else in ./tests/common is built once and shared between all packages.
+extern const char* const intest_title_id;
+extern const char* const intest_default_junit_path; // Empty when JUnit output is off by default
+extern const char* const intest_default_mem_scan_mode;
+extern const uint32_t    intest_fw_version; // Like FW_VER, for sources compiled with create_test_objects
+
+// main() body for all test packages (see main.cpp): sets up stdout, installs the runner plugins and runs every test.
+// Runner options are handled here and removed before CppUTest parses the rest of the arguments:
+//   --junit            write JUnit XML to /data/<title id>_junit.xml
+//   --junit=<path>     write JUnit XML to <path>, has to be under /data or /download0
+//   --mem-scan=<mode>  full, diff or binary, see mem_scan.h
+//   --vma-leaks=<mode> off, report (default) or fail, see vma_leak_plugin.h
+//   --shard=<i>/<n>    split the tests into n shards and only run shard i (0 based), see runner_select_shard
+//   --test-timeout=<s> end the run when a single test takes longer than this (default 600, 0 disables)
+//   --timeout=<s>      end the run when all tests together take longer than this (default 3600, 0 disables)
+// The defaults come from the INTEST_JUNIT_PATH and INTEST_MEM_SCAN_MODE CMake cache variables.
+// Arguments are also read from /data/<title id>_args.txt, or /app0/intest_args.txt (INTEST_ARGS in finalize_pkg),
+// and go before the launch arguments. CppUTest options like -g <group> and -n <name> work there too.
+int intest_run_all_tests(int ac, char** av);
+
+// printf for tests and the helpers they call (mem_scan, benchmarks). Prints to stdout, and while a test runs with JUnit
+// output on, also into the <system-out> of that test case.
+int intest_printf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+// Writes (and truncates) a file with sceKernel calls, returns false and prints the error on failure.
+bool intest_write_file(const char* path, const std::string& data);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "kernel.h"
+#include "mem_helpers.h"
+#include "mem_scan.h"
+#include "runner.h"
+#include "watchdog.h"
+
+// Also a watchdog checkpoint, a test that hangs is reported with the last check it passed.
+#define UNSIGNED_INT_EQUALS(expected, actual)                                                                                                                  \
+  do {                                                                                                                                                         \
+    intest_checkpoint(__FILE__, __LINE__);                                                                                                                     \
+    UNSIGNED_LONGS_EQUAL_LOCATION((uint32_t)expected, (uint32_t)actual, NULLPTR, __FILE__, __LINE__);                                                          \
+  } while (0)
+
+#define mem_scan() _mem_scan(__FILE__, __LINE__)
+
+static inline void _mem_scan(const char* file, int line) {
+  // Prints the memory map, how depends on the mode passed to the runner (--mem-scan=full|diff|binary).
+  intest_checkpoint(file, line);
+  intest_mem_scan(file, line);
+}
@@ -0,0 +1,73 @@
+#include "timing_plugin.h"
+
+#include "kernel.h"
+#include "runner.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+#include <string>
+
+static void timing_append_escaped(std::string& out, const char* str) {
+  for (; *str != '\0'; ++str) {
+    if (*str == '"' || *str == '\\') out += '\\';
+    out += *str;
+  }
+}
+
+TimingPlugin::TimingPlugin(): TestPlugin("TimingPlugin") {
+  // Allocate everything up front, growing the vector from postTestAction would show up as a leak in the test.
+  // Tests are registered during static initialization, so the count is known here.
+  timings.reserve(TestRegistry::getCurrentRegistry()->countTests());
+}
+
+void TimingPlugin::preTestAction(UtestShell& test, TestResult& result) {
+  start_ticks = sceKernelReadTsc();
+}
+
+void TimingPlugin::postTestAction(UtestShell& test, TestResult& result) {
+  uint64_t ticks = sceKernelReadTsc() - start_ticks;
+  // Repeated runs (-r) only keep the first one.
+  if (timings.size() < timings.capacity()) timings.push_back({&test, ticks, !test.hasFailed()});
+}
+
+void TimingPlugin::abort(const UtestShell* test) {
+  uint64_t ticks = sceKernelReadTsc() - start_ticks;
+  if (test != nullptr && timings.size() < timings.capacity()) timings.push_back({test, ticks, false});
+  report();
+}
+
+void TimingPlugin::report() {
+  const double ns_per_tick = 1000000000.0 / double(sceKernelGetTscFrequency());
+  char         number[32];
+  std::string  json;
+  json.reserve(256 + timings.size() * 160);
+
+  snprintf(number, sizeof(number), "%llu", (unsigned long long)sceKernelGetProcessTime());
+  json += "{\"title_id\":\"";
+  json += intest_title_id;
+  json += "\",\"process_time_us\":";
+  json += number;
+  json += ",\"tests\":[";
+  for (size_t i = 0; i < timings.size(); ++i) {
+    const TestTiming& timing = timings[i];
+    json += i == 0 ? "{\"group\":\"" : ",{\"group\":\"";
+    timing_append_escaped(json, timing.test->getGroup().asCharString());
+    json += "\",\"name\":\"";
+    timing_append_escaped(json, timing.test->getName().asCharString());
+    json += "\",\"file\":\"";
+    timing_append_escaped(json, timing.test->getFile().asCharString());
+    snprintf(number, sizeof(number), "%zu", timing.test->getLineNumber());
+    json += "\",\"line\":";
+    json += number;
+    snprintf(number, sizeof(number), "%.0f", double(timing.ticks) * ns_per_tick);
+    json += ",\"duration_ns\":";
+    json += number;
+    json += timing.passed ? ",\"passed\":true}" : ",\"passed\":false}";
+  }
+  json += "]}\n";
+
+  printf("[timing] %s", json.c_str());
+  char path[64];
+  snprintf(path, sizeof(path), "/data/%s_timing.json", intest_title_id);
+  intest_write_file(path, json);
+}
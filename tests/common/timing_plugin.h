@@ -0,0 +1,33 @@
+#pragma once
+
+#include <CppUTest/TestPlugin.h>
+#include <cstdint>
+#include <vector>
+
+// Times every TEST with the TSC and writes a JSON summary once all tests ran.
+// The summary is printed to stdout on a single line prefixed with "[timing]" and written to /data/<title id>_timing.json:
+// {"title_id":"MEMT00100","process_time_us":123,"tests":[{"group":"MemoryTests","name":"MapTest","file":"...","line":10,"duration_ns":456,"passed":true}]}
+class TimingPlugin: public TestPlugin {
+public:
+  TimingPlugin();
+
+  void preTestAction(UtestShell& test, TestResult& result) override;
+  void postTestAction(UtestShell& test, TestResult& result) override;
+
+  // Call after RUN_ALL_TESTS, prints and writes the summary.
+  void report();
+
+  // Prints and writes the summary so far when the watchdog ends the run, the active test counts as failed.
+  void abort(const UtestShell* test);
+
+private:
+  // Tests are static objects, keeping the shell avoids copying names while CppUTest leak detection is active.
+  struct TestTiming {
+    const UtestShell* test;
+    uint64_t          ticks;
+    bool              passed;
+  };
+
+  std::vector<TestTiming> timings;
+  uint64_t                start_ticks = 0;
+};
@@ -0,0 +1,74 @@
+#include "vma_leak_plugin.h"
+
+#include "kernel.h"
+#include "mem_scan.h"
+#include "runner.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+#include <cstring>
+
+// Static like the mem_scan() snapshots, nothing here may allocate while CppUTest checks for leaks.
+static MemScanInfo vma_leak_before[mem_scan_capacity];
+static MemScanInfo vma_leak_after[mem_scan_capacity];
+
+static uint64_t vma_leak_flexible_available() {
+  uint64_t size = 0;
+  sceKernelAvailableFlexibleMemorySize(&size);
+  return size;
+}
+
+// There is no call for the total amount of free direct memory, the largest free extent still shows leaks.
+static uint64_t vma_leak_direct_available() {
+  int64_t  phys_addr = 0;
+  uint64_t size      = 0;
+  sceKernelAvailableDirectMemorySize(0, sceKernelGetDirectMemorySize(), 0, &phys_addr, &size);
+  return size;
+}
+
+VmaLeakPlugin::VmaLeakPlugin(Mode mode): TestPlugin("VmaLeakPlugin"), mode(mode) {
+  if (mode == Mode::Off) disable();
+}
+
+bool VmaLeakPlugin::parse_mode(const char* name, Mode* mode) {
+  if (strcmp(name, "off") == 0) {
+    *mode = Mode::Off;
+  } else if (strcmp(name, "report") == 0) {
+    *mode = Mode::Report;
+  } else if (strcmp(name, "fail") == 0) {
+    *mode = Mode::Fail;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void VmaLeakPlugin::preTestAction(UtestShell& test, TestResult& result) {
+  before_count    = intest_capture_memory_map(vma_leak_before, mem_scan_capacity);
+  before_flexible = vma_leak_flexible_available();
+  before_direct   = vma_leak_direct_available();
+}
+
+void VmaLeakPlugin::postTestAction(UtestShell& test, TestResult& result) {
+  size_t   after_count    = intest_capture_memory_map(vma_leak_after, mem_scan_capacity);
+  uint64_t after_flexible = vma_leak_flexible_available();
+  uint64_t after_direct   = vma_leak_direct_available();
+  if (before_count == SIZE_MAX || after_count == SIZE_MAX) {
+    intest_printf("VmaLeakPlugin: more than %zu areas, %s.%s not checked\n", mem_scan_capacity, test.getGroup().asCharString(), test.getName().asCharString());
+    return;
+  }
+
+  MemScanDiff diff = intest_diff_memory_maps(vma_leak_before, before_count, vma_leak_after, after_count, false);
+  if (diff.added == 0 && diff.removed == 0 && before_flexible == after_flexible && before_direct == after_direct) return;
+
+  intest_printf("VmaLeakPlugin: %s.%s changed the memory map: %zu areas added, %zu removed, %lld bytes mapped, flexible available %lld, "
+                "largest free direct extent %lld\n",
+                test.getGroup().asCharString(), test.getName().asCharString(), diff.added, diff.removed, (long long)diff.bytes,
+                (long long)(after_flexible - before_flexible), (long long)(after_direct - before_direct));
+  intest_diff_memory_maps(vma_leak_before, before_count, vma_leak_after, after_count, true);
+
+  if (mode == Mode::Fail) {
+    TestFailure failure(&test, "VmaLeakPlugin: test left the memory map or memory budgets changed, see the output above");
+    result.addFailure(failure);
+  }
+}
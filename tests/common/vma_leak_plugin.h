@@ -0,0 +1,27 @@
+#pragma once
+
+#include <CppUTest/TestPlugin.h>
+#include <cstdint>
+
+// Snapshots the memory map and the flexible/direct memory budgets before every test and compares them after teardown.
+// A test that leaves mappings behind pollutes the address space for every test that runs after it, and the leaked
+// budget makes later benchmark numbers drift, so leftovers are printed with the test name.
+// Report only prints, Fail also turns every leak into a test failure.
+class VmaLeakPlugin: public TestPlugin {
+public:
+  enum class Mode { Off, Report, Fail };
+
+  explicit VmaLeakPlugin(Mode mode);
+
+  void preTestAction(UtestShell& test, TestResult& result) override;
+  void postTestAction(UtestShell& test, TestResult& result) override;
+
+  // Parses off/report/fail, returns false for anything else.
+  static bool parse_mode(const char* name, Mode* mode);
+
+private:
+  Mode     mode;
+  size_t   before_count    = 0;
+  uint64_t before_flexible = 0;
+  uint64_t before_direct   = 0;
+};
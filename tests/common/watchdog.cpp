@@ -0,0 +1,90 @@
+#include "watchdog.h"
+
+#include "kernel.h"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdio>
+#include <orbis/SystemService.h>
+
+static std::atomic<const char*> watchdog_checkpoint_file = nullptr;
+static std::atomic<int>         watchdog_checkpoint_line = 0;
+
+void intest_checkpoint(const char* file, int line) {
+  watchdog_checkpoint_file.store(file, std::memory_order_relaxed);
+  watchdog_checkpoint_line.store(line, std::memory_order_relaxed);
+}
+
+WatchdogPlugin::WatchdogPlugin(uint32_t test_timeout, uint32_t total_timeout, TimeoutHandler on_timeout)
+    : TestPlugin("WatchdogPlugin"), test_timeout(test_timeout), total_timeout(total_timeout), on_timeout(on_timeout) {}
+
+void WatchdogPlugin::preTestAction(UtestShell& test, TestResult& result) {
+  intest_checkpoint(test.getFile().asCharString(), int(test.getLineNumber()));
+  test_start.store(sceKernelReadTsc());
+  current.store(&test);
+}
+
+void WatchdogPlugin::postTestAction(UtestShell& test, TestResult& result) {
+  current.store(nullptr);
+}
+
+void WatchdogPlugin::start() {
+  run_start = sceKernelReadTsc();
+  if (test_timeout == 0 && total_timeout == 0) return;
+  int32_t result = scePthreadCreate(&thread, nullptr, thread_entry, this, "intest_watchdog");
+  if (result != 0) {
+    printf("intest: failed to start the watchdog: 0x%08x\n", result);
+    thread = nullptr;
+  }
+}
+
+void WatchdogPlugin::stop() {
+  if (thread == nullptr) return;
+  stopping.store(true);
+  scePthreadJoin(thread, nullptr);
+  thread = nullptr;
+}
+
+void* WatchdogPlugin::thread_entry(void* arg) {
+  static_cast<WatchdogPlugin*>(arg)->run();
+  return nullptr;
+}
+
+void WatchdogPlugin::run() {
+  const uint64_t frequency = sceKernelGetTscFrequency();
+  char           message[128];
+  while (!stopping.load()) {
+    sceKernelUsleep(100000);
+
+    // current is set last in preTestAction, so test_start always belongs to it.
+    const UtestShell* test = current.load();
+    uint64_t          now  = sceKernelReadTsc();
+    if (test != nullptr && test_timeout != 0 && now - test_start.load() > test_timeout * frequency) {
+      snprintf(message, sizeof(message), "test did not finish within %u seconds", test_timeout);
+      expire(test, message);
+    } else if (total_timeout != 0 && now - run_start > total_timeout * frequency) {
+      snprintf(message, sizeof(message), "tests did not finish within %u seconds", total_timeout);
+      expire(test, message);
+    }
+  }
+}
+
+void WatchdogPlugin::expire(const UtestShell* test, const char* message) {
+  const char* file = watchdog_checkpoint_file.load();
+  int         line = watchdog_checkpoint_line.load();
+
+  printf("\n[watchdog] %s\n", message);
+  if (test != nullptr) {
+    printf("[watchdog] active test: TEST(%s, %s) at %s:%zu\n", test->getGroup().asCharString(), test->getName().asCharString(),
+           test->getFile().asCharString(), test->getLineNumber());
+  }
+  if (file != nullptr) printf("[watchdog] last checkpoint: %s:%d\n", file, line);
+
+  if (on_timeout != nullptr) on_timeout(test, file, line, message);
+
+  printf("[watchdog] exiting\n");
+  sceSystemServiceLoadExec("EXIT", nullptr);
+  // Exiting is asynchronous, wait for it here instead of checking the limits again.
+  while (true) {
+    sceKernelUsleep(1000000);
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <CppUTest/TestPlugin.h>
+#include <atomic>
+#include <cstdint>
+
+// Records the last place a test got to, the watchdog prints it when a test hangs.
+// UNSIGNED_INT_EQUALS and mem_scan() set it, so it is usually the last check before the call that never returned.
+void intest_checkpoint(const char* file, int line);
+
+// Ends the package when a test or the whole run takes too long, instead of hanging until the console is killed.
+// A thread checks the limits every 100ms. When one is hit it prints the active test and the last checkpoint, calls
+// the timeout handler so the runner can write the results it has and exits with sceSystemServiceLoadExec("EXIT").
+// Install it after the other plugins, then the test time includes what they do around the test.
+class WatchdogPlugin: public TestPlugin {
+public:
+  // Called on the watchdog thread while the test thread is still stuck, test is nullptr between tests.
+  typedef void (*TimeoutHandler)(const UtestShell* test, const char* file, int line, const char* message);
+
+  // Limits are in seconds, 0 disables a limit.
+  WatchdogPlugin(uint32_t test_timeout, uint32_t total_timeout, TimeoutHandler on_timeout);
+
+  void preTestAction(UtestShell& test, TestResult& result) override;
+  void postTestAction(UtestShell& test, TestResult& result) override;
+
+  // The total limit counts from start(), stop() waits for the thread.
+  void start();
+  void stop();
+
+private:
+  static void* thread_entry(void* arg);
+  void         run();
+  void         expire(const UtestShell* test, const char* message);
+
+  uint32_t                       test_timeout;
+  uint32_t                       total_timeout;
+  TimeoutHandler                 on_timeout;
+  void*                          thread    = nullptr;
+  uint64_t                       run_start = 0;
+  std::atomic<bool>              stopping  = false;
+  std::atomic<const UtestShell*> current   = nullptr;
+  std::atomic<uint64_t>          test_start{0};
+};
@@ -1,3 +1,18 @@
+set(INTEST_COMMON_DIR ${CMAKE_CURRENT_LIST_DIR}/common)
+set(INTEST_JUNIT_PATH "" CACHE STRING "Write JUnit XML results to this path on the console by default, has to be under /data or /download0")
+set(INTEST_MEM_SCAN_MODE "full" CACHE STRING "Default mem_scan() mode: full, diff or binary")
+set(INTEST_PCH OFF CACHE BOOL "Precompile the CppUTest and standard library headers the tests share")
+set(INTEST_UNITY_BUILD OFF CACHE BOOL "Compile the sources of every package and intest library as unity files")
+
+# Headers precompiled with INTEST_PCH. Only headers that don't depend on the package, so the precompiled
+# header of the intest library can be reused by the packages.
+set(INTEST_PCH_HEADERS <cstdint> <cstdio> <cstring> <list> <vector> <CppUTest/TestHarness.h>)
+
+# The superbuild forwards these even when they are not set.
+if(NOT INTEST_MEM_SCAN_MODE)
+  set(INTEST_MEM_SCAN_MODE "full")
+endif()
+
 # Description:
 # This function creates an OpenOrbis prx library with specified parameters.
 #
@@ -28,14 +43,7 @@ function(create_lib work_lib_name fw_version pkg_title_id inst_path out_lib_name
     message(FATAL_ERROR "Specified target (${pkg_title_id}) does not exist, I don't know where to install the library.")
   endif()
 
-  get_target_property(install_dir ${pkg_title_id} OO_PKG_ROOT)
-
   if(TARGET ${work_lib_name})
-    get_target_property(prx_file ${work_lib_name} OO_FSELF_PATH)
-    install(FILES ${prx_file}
-      DESTINATION "${install_dir}/${inst_path}"
-      RENAME "${out_lib_name}"
-    )
     set(prx_first_occur FALSE PARENT_SCOPE)
   else()
     add_library(${work_lib_name} SHARED
@@ -43,13 +51,11 @@ function(create_lib work_lib_name fw_version pkg_title_id inst_path out_lib_name
       ${ARGN}
     )
     OpenOrbis_AddFSelfCommand(${work_lib_name} ${CMAKE_CURRENT_BINARY_DIR} ${work_lib_name} ${fw_version})
-
-    install(FILES ${CMAKE_CURRENT_BINARY_DIR}/${work_lib_name}.prx
-      DESTINATION "${install_dir}/${inst_path}"
-      RENAME "${out_lib_name}"
-    )
     set(prx_first_occur TRUE PARENT_SCOPE)
   endif()
+
+  get_target_property(prx_file ${work_lib_name} OO_FSELF_PATH)
+  OpenOrbisPackage_AddFile(${pkg_title_id} "${prx_file}" "${inst_path}/${out_lib_name}" ${work_lib_name})
 endfunction()
 
 function(internal_create_stub_libs pkg_title_id fw_version)
@@ -67,6 +73,84 @@ function(internal_create_stub_libs pkg_title_id fw_version)
   endif()
 endfunction()
 
+# Description:
+# Builds the test support library from ./tests/common once and reuses it for every package: kernel prototypes,
+# map helpers, mem_scan, the runner plugins and main(). Nothing in it depends on the firmware version, that is
+# part of the <title id>_info.cpp create_pkg generates. Called by ./tests/CMakeLists.txt before the tests are
+# added, so the library is compiled with the flags of ./tests only.
+function(create_intest_lib)
+  add_library(intest STATIC
+    ${INTEST_COMMON_DIR}/main.cpp
+    ${INTEST_COMMON_DIR}/runner.cpp
+    ${INTEST_COMMON_DIR}/timing_plugin.cpp
+    ${INTEST_COMMON_DIR}/junit_output.cpp
+    ${INTEST_COMMON_DIR}/mem_scan.cpp
+    ${INTEST_COMMON_DIR}/mem_helpers.cpp
+    ${INTEST_COMMON_DIR}/vma_leak_plugin.cpp
+    ${INTEST_COMMON_DIR}/watchdog.cpp
+  )
+  # Packages link with -pie
+  set_target_properties(intest PROPERTIES POSITION_INDEPENDENT_CODE ON)
+  target_include_directories(intest PUBLIC ${INTEST_COMMON_DIR})
+  target_link_libraries(intest PUBLIC SceSystemService)
+  set_target_properties(intest PROPERTIES UNITY_BUILD "${INTEST_UNITY_BUILD}")
+
+  if(INTEST_PCH)
+    target_precompile_headers(intest PRIVATE ${INTEST_PCH_HEADERS})
+  endif()
+endfunction()
+
+# Description:
+# Applies INTEST_UNITY_BUILD and INTEST_PCH to a target that compiles test sources.
+#
+# Params:
+# target - the package or test objects target
+function(internal_set_test_build_options target)
+  # Test sources prefix their static names with the file name, so they can share a unity file.
+  set_target_properties(${target} PROPERTIES UNITY_BUILD "${INTEST_UNITY_BUILD}")
+
+  if(NOT INTEST_PCH)
+    return()
+  endif()
+
+  # Targets in folders that don't add include directories, options or definitions are compiled like intest
+  # and reuse its precompiled header. Definitions on the target itself, like FW_VER, don't prevent that.
+  get_target_property(intest_dir intest SOURCE_DIR)
+
+  foreach(property INCLUDE_DIRECTORIES COMPILE_OPTIONS COMPILE_DEFINITIONS)
+    get_directory_property(intest_value DIRECTORY ${intest_dir} ${property})
+    get_directory_property(current_value ${property})
+
+    if(NOT "${intest_value}" STREQUAL "${current_value}")
+      target_precompile_headers(${target} PRIVATE ${INTEST_PCH_HEADERS})
+      return()
+    endif()
+  endforeach()
+
+  target_precompile_headers(${target} REUSE_FROM intest)
+endfunction()
+
+# Description:
+# Compiles test sources once for several packages, i.e. the same tests packed for different firmware versions.
+# The sources are compiled without the FW_VER_MAJOR, FW_VER_MINOR and FW_VER definitions of create_pkg, the
+# firmware version of the package is intest_fw_version (see ./tests/common/runner.h). Pass the name to create_pkg
+# in place of the sources, the package then only compiles its generated <title id>_info.cpp and links.
+#
+# Params:
+# objects_name - Name for the object library target in CMake project
+# vararg... - The list of files to compile
+function(create_test_objects objects_name)
+  list(LENGTH ARGN source_count)
+
+  if(source_count LESS 1)
+    message(FATAL_ERROR "No source files were provided to the create_test_objects call")
+  endif()
+
+  add_library(${objects_name} OBJECT ${ARGN})
+  target_link_libraries(${objects_name} PRIVATE intest)
+  internal_set_test_build_options(${objects_name})
+endfunction()
+
 # Description:
 # This function is a first stage for pkg creation. The `finalize_pkg` function should always
 # be called after this one. It is allowed to change CMake's target properties for package
@@ -78,7 +162,7 @@ endfunction()
 # title_id - the package title id
 # fw_major - the major firmware version
 # fw_minor - the first two digits of minor firmware version
-# vararg... - The list of files to compile into a eboot.bin file
+# vararg... - The list of files to compile into a eboot.bin file, and create_test_objects targets to link
 #
 # Result:
 # Creates a target with the `title_id` name, this target builds the eboot.bin file and necessary
@@ -130,9 +214,20 @@ function(create_pkg title_id fw_major fw_minor)
   # Print debug info if needed
   message(STATUS "Creating package id:${title_id} fw:${fw_version_hex}")
 
+  set(pkg_sources)
+  set(pkg_objects)
+
+  foreach(source ${ARGN})
+    if(TARGET ${source})
+      list(APPEND pkg_objects ${source})
+    else()
+      list(APPEND pkg_sources ${source})
+    endif()
+  endforeach()
+
   add_executable(${title_id}
     ${OO_PS4_TOOLCHAIN}/lib/crt1.o
-    ${ARGN}
+    ${pkg_sources}
   )
 
   string(SUBSTRING "${title_id}" 0 4 default_title)
@@ -150,9 +245,24 @@ function(create_pkg title_id fw_major fw_minor)
     PRIVATE FW_VER_MAJOR=${fw_major} FW_VER_MINOR=${fw_minor} FW_VER="${fw_version_hex}u"
   )
 
-  target_link_options(${title_id} PRIVATE -pie)
+  # Per-package settings for the shared runner, everything else comes from the intest library.
+  set(junit_path "")
+  if(INTEST_JUNIT_PATH)
+    # {title_id} in the path is replaced, so one setting works for every package.
+    string(REPLACE "{title_id}" "${title_id}" junit_path "${INTEST_JUNIT_PATH}")
+  endif()
+
+  configure_file(${INTEST_COMMON_DIR}/package_info.cpp.in ${CMAKE_CURRENT_BINARY_DIR}/${title_id}_info.cpp @ONLY)
+  target_sources(${title_id} PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/${title_id}_info.cpp)
+
+  target_link_libraries(${title_id} PRIVATE intest ${pkg_objects})
+
+  # Packages built only from test objects just compile the generated file.
+  if(pkg_sources)
+    internal_set_test_build_options(${title_id})
+  endif()
 
-  add_dependencies(${title_id} CppUTest)
+  target_link_options(${title_id} PRIVATE -pie)
 
   OpenOrbisPackage_PostProject(${title_id} ${fw_version_hex})
 
@@ -165,8 +275,19 @@ endfunction(create_pkg)
 # Changing target parameters after this call could lead to
 # undefined behavior and compilation fails.
 #
+# The INTEST_ARGS target property can be set before this call, the list is written to
+# /app0/intest_args.txt and the runner uses it as default arguments (see ./tests/common/runner.h).
+#
 # Params:
 # title_id - the package title id
 function(finalize_pkg pkg_title_id)
+  get_target_property(pkg_args ${pkg_title_id} INTEST_ARGS)
+
+  if(pkg_args)
+    string(REPLACE ";" "\n" pkg_args "${pkg_args}")
+    file(CONFIGURE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${pkg_title_id}_args.txt CONTENT "${pkg_args}\n")
+    OpenOrbisPackage_AddFile(${pkg_title_id} ${CMAKE_CURRENT_BINARY_DIR}/${pkg_title_id}_args.txt "intest_args.txt")
+  endif()
+
   OpenOrbisPackage_FinalizeProject(${pkg_title_id})
 endfunction(finalize_pkg)
@@ -0,0 +1,115 @@
+#include "sfo_attributes.h"
+#include "sfo_file.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+struct SfoKey {
+  const char* key;
+  bool        integer;
+  uint32_t    max_size;       // Including the terminating zero, strings only
+  int         attribute_word; // 1 or 2 for ATTRIBUTE and ATTRIBUTE2
+};
+
+// The keys the packages use, with the types and sizes the PkgTool based scripts used.
+static const SfoKey sfo_keys[] = {
+    {"APP_TYPE", true, 4, 0},
+    {"APP_VER", false, 8, 0},
+    {"ATTRIBUTE", true, 4, 1},
+    {"ATTRIBUTE2", true, 4, 2},
+    {"CATEGORY", false, 4, 0},
+    {"CONTENT_ID", false, 48, 0},
+    {"DOWNLOAD_DATA_SIZE", true, 4, 0},
+    {"SYSTEM_VER", true, 4, 0},
+    {"TITLE", false, 128, 0},
+    {"TITLE_ID", false, 12, 0},
+    {"VERSION", false, 8, 0},
+};
+
+static void usage() {
+  printf("Usage: intest_sfo <params file> <param.sfo>\n"
+         "\n"
+         "Writes a param.sfo from KEY=value lines, # starts a comment. Known keys:\n"
+         "APP_TYPE, APP_VER, ATTRIBUTE, ATTRIBUTE2, CATEGORY, CONTENT_ID, DOWNLOAD_DATA_SIZE, SYSTEM_VER, TITLE, TITLE_ID, VERSION\n"
+         "ATTRIBUTE and ATTRIBUTE2 take numbers and SfoAttributes bit names separated by ',' or '|', ATTRIBUTE2 is\n"
+         "left out when it is 0.\n");
+}
+
+static bool set_entry(SfoFile* sfo, const std::string& key, const std::string& value, std::string* error) {
+  const SfoKey* found = nullptr;
+  for (const SfoKey& sfo_key: sfo_keys) {
+    if (key == sfo_key.key) found = &sfo_key;
+  }
+  if (found == nullptr) {
+    *error = "unknown key " + key;
+    return false;
+  }
+
+  if (!found->integer) {
+    if (sfo->set_string(key, value, found->max_size)) return true;
+    *error = key + " is longer than " + std::to_string(found->max_size - 1) + " bytes";
+    return false;
+  }
+
+  uint32_t number = 0;
+  if (found->attribute_word != 0) {
+    if (!sfo_parse_attributes(value, found->attribute_word, &number, error)) return false;
+    if (number == 0 && found->attribute_word == 2) return true;
+  } else {
+    char*    end    = nullptr;
+    uint64_t parsed = strtoull(value.c_str(), &end, 0);
+    if (end == value.c_str() || *end != '\0' || parsed > UINT32_MAX) {
+      *error = key + " needs a 32 bit number, got " + value;
+      return false;
+    }
+    number = uint32_t(parsed);
+  }
+  sfo->set_integer(key, number);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    usage();
+    return 2;
+  }
+
+  std::ifstream params(argv[1]);
+  if (!params) {
+    fprintf(stderr, "intest_sfo: %s: %s\n", argv[1], strerror(errno));
+    return 1;
+  }
+
+  SfoFile     sfo;
+  std::string line;
+  std::string error;
+  size_t      line_number = 0;
+  while (std::getline(params, line)) {
+    ++line_number;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line[start] == '#') continue;
+
+    size_t equals = line.find('=', start);
+    if (equals == std::string::npos) {
+      fprintf(stderr, "intest_sfo: %s:%zu: expected KEY=value\n", argv[1], line_number);
+      return 1;
+    }
+    std::string key = line.substr(start, equals - start);
+    key.erase(key.find_last_not_of(" \t") + 1);
+    if (!set_entry(&sfo, key, line.substr(equals + 1), &error)) {
+      fprintf(stderr, "intest_sfo: %s:%zu: %s\n", argv[1], line_number, error.c_str());
+      return 1;
+    }
+  }
+
+  if (!sfo.write(argv[2], &error)) {
+    fprintf(stderr, "intest_sfo: %s\n", error.c_str());
+    return 1;
+  }
+  return 0;
+}
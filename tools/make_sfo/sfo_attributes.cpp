@@ -0,0 +1,84 @@
+#include "sfo_attributes.h"
+
+#include <cstdlib>
+#include <cstring>
+
+struct SfoAttributeBit {
+  const char* name;
+  int         word;
+  int         bit;
+};
+
+// Same bits as SfoAttributes in tests/code/template/code/sfoparams.h, the unknown ones can be set by value.
+static const SfoAttributeBit sfo_attribute_bits[] = {
+    {"isInitUserLogoutSupported", 1, 0},
+    {"dialogEnterButtonAssignment", 1, 1},
+    {"menuWarningForPsMove", 1, 2},
+    {"supportsStereoscopic3D", 1, 3},
+    {"suspendsOnPsButtonPress", 1, 4},
+    {"systemDialogEnterButtonAssignment", 1, 5},
+    {"isOverwritesDefaultShareMenu", 1, 6},
+    {"suspendsOnSpecialOutputResolution", 1, 8},
+    {"isHdcpEnabled", 1, 9},
+    {"isHdcpDisabledForNonGames", 1, 10},
+    {"isVrSupported", 1, 14},
+    {"isSixCpuMode", 1, 15},
+    {"isSevenCpuMode", 1, 16},
+    {"isNeoModeSupported", 1, 23},
+    {"isVrRequired", 1, 26},
+    {"isHdrSupported", 1, 29},
+    {"displayLocation", 1, 31},
+
+    {"isVideoRecordingSupported", 2, 1},
+    {"isContentSearchSupported", 2, 2},
+    {"isPsVrEyeToEyeDistanceDisabled", 2, 4},
+    {"isPsVrEyeToEyeDistanceChangeable", 2, 5},
+    {"isBroadcastSeparateModeSupported", 2, 8},
+    {"doNotApplyDummyLoadForTrackingMove", 2, 9},
+    {"isOneOnOneMatchEventSupported", 2, 11},
+    {"isTeamOnTeamTournamentSupported", 2, 12},
+    {"noTwoMegabytePages", 2, 15},
+    {"reserveTwoMegabytePagesForRoDataAndText", 2, 16},
+    {"useImprovedThreadScheduler", 2, 20},
+    {"appRunsOnPlayStation5AndComplyTRC4211", 2, 23},
+    {"forceGpu800MHzClockCounter", 2, 26},
+};
+
+bool sfo_parse_attributes(const std::string& text, int word, uint32_t* value, std::string* error) {
+  *value     = 0;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t start = text.find_first_not_of(",| \t", pos);
+    if (start == std::string::npos) break;
+    size_t end = text.find_first_of(",| \t", start);
+    if (end == std::string::npos) end = text.size();
+    pos = end;
+
+    std::string token  = text.substr(start, end - start);
+    char*       number = nullptr;
+    uint64_t    bits   = strtoull(token.c_str(), &number, 0);
+    if (number != token.c_str() && *number == '\0') {
+      if (bits > UINT32_MAX) {
+        *error = token + " doesn't fit in 32 bits";
+        return false;
+      }
+      *value |= uint32_t(bits);
+      continue;
+    }
+
+    const SfoAttributeBit* found = nullptr;
+    for (const SfoAttributeBit& attribute: sfo_attribute_bits) {
+      if (token == attribute.name) found = &attribute;
+    }
+    if (found == nullptr) {
+      *error = "unknown attribute " + token;
+      return false;
+    }
+    if (found->word != word) {
+      *error = token + " is an ATTRIBUTE" + (found->word == 1 ? "" : "2") + " bit";
+      return false;
+    }
+    *value |= 1u << found->bit;
+  }
+  return true;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Parses an ATTRIBUTE or ATTRIBUTE2 value (word 1 or 2). The value is a list separated by ',', '|' or spaces of
+// numbers and bit names, the names are the ones from SfoAttributes in tests/code/template/code/sfoparams.h:
+// "isSevenCpuMode", "0x10000", "isNeoModeSupported|isHdrSupported".
+bool sfo_parse_attributes(const std::string& text, int word, uint32_t* value, std::string* error);
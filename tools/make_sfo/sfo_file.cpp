@@ -0,0 +1,107 @@
+#include "sfo_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+static const uint32_t sfo_magic        = 0x46535000; // "\0PSF"
+static const uint32_t sfo_version      = 0x00000101;
+static const uint16_t sfo_format_utf8  = 0x0204; // Zero terminated
+static const uint16_t sfo_format_int32 = 0x0404;
+static const size_t   sfo_header_size  = 0x14;
+static const size_t   sfo_index_size   = 0x10;
+
+static void put_u16(std::vector<uint8_t>& out, size_t offset, uint16_t value) {
+  out[offset + 0] = uint8_t(value);
+  out[offset + 1] = uint8_t(value >> 8);
+}
+
+static void put_u32(std::vector<uint8_t>& out, size_t offset, uint32_t value) {
+  for (size_t i = 0; i < 4; ++i) {
+    out[offset + i] = uint8_t(value >> (i * 8));
+  }
+}
+
+void SfoFile::set(Entry entry) {
+  auto existing = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) { return e.key == entry.key; });
+  if (existing != entries_.end()) {
+    *existing = std::move(entry);
+    return;
+  }
+  auto position = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) { return e.key > entry.key; });
+  entries_.insert(position, std::move(entry));
+}
+
+void SfoFile::set_integer(const std::string& key, uint32_t value) {
+  Entry entry;
+  entry.key      = key;
+  entry.format   = sfo_format_int32;
+  entry.size     = 4;
+  entry.max_size = 4;
+  entry.data.resize(4);
+  put_u32(entry.data, 0, value);
+  set(std::move(entry));
+}
+
+bool SfoFile::set_string(const std::string& key, const std::string& value, uint32_t max_size) {
+  if (value.size() + 1 > max_size) return false;
+  Entry entry;
+  entry.key      = key;
+  entry.format   = sfo_format_utf8;
+  entry.size     = uint32_t(value.size() + 1);
+  entry.max_size = max_size;
+  entry.data.assign(value.begin(), value.end());
+  entry.data.push_back(0);
+  set(std::move(entry));
+  return true;
+}
+
+std::vector<uint8_t> SfoFile::serialize() const {
+  size_t key_table_size  = 0;
+  size_t data_table_size = 0;
+  for (const Entry& entry: entries_) {
+    key_table_size += entry.key.size() + 1;
+    data_table_size += entry.max_size;
+  }
+  key_table_size = (key_table_size + 3) & ~size_t(3);
+
+  const size_t         key_table_start  = sfo_header_size + entries_.size() * sfo_index_size;
+  const size_t         data_table_start = key_table_start + key_table_size;
+  std::vector<uint8_t> out(data_table_start + data_table_size, 0);
+  put_u32(out, 0x00, sfo_magic);
+  put_u32(out, 0x04, sfo_version);
+  put_u32(out, 0x08, uint32_t(key_table_start));
+  put_u32(out, 0x0C, uint32_t(data_table_start));
+  put_u32(out, 0x10, uint32_t(entries_.size()));
+
+  size_t key_offset  = 0;
+  size_t data_offset = 0;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const Entry& entry = entries_[i];
+    const size_t index = sfo_header_size + i * sfo_index_size;
+    put_u16(out, index + 0x0, uint16_t(key_offset));
+    put_u16(out, index + 0x2, entry.format);
+    put_u32(out, index + 0x4, entry.size);
+    put_u32(out, index + 0x8, entry.max_size);
+    put_u32(out, index + 0xC, uint32_t(data_offset));
+    memcpy(out.data() + key_table_start + key_offset, entry.key.c_str(), entry.key.size() + 1);
+    memcpy(out.data() + data_table_start + data_offset, entry.data.data(), entry.data.size());
+    key_offset += entry.key.size() + 1;
+    data_offset += entry.max_size;
+  }
+  return out;
+}
+
+bool SfoFile::write(const std::string& path, std::string* error) const {
+  std::vector<uint8_t> data = serialize();
+  FILE*                file = fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    *error = path + ": " + strerror(errno);
+    return false;
+  }
+  bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+  written      = fclose(file) == 0 && written;
+  if (!written) *error = path + ": write failed";
+  return written;
+}
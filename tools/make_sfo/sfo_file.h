@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// param.sfo writer, the format is described at https://www.psdevwiki.com/ps4/Param.sfo
+// Entries are written sorted by key like PkgTool does, each one takes max_size bytes in the data table.
+class SfoFile {
+public:
+  void set_integer(const std::string& key, uint32_t value);
+  // max_size includes the terminating zero. Returns false if the value doesn't fit.
+  bool set_string(const std::string& key, const std::string& value, uint32_t max_size);
+
+  std::vector<uint8_t> serialize() const;
+  bool                 write(const std::string& path, std::string* error) const;
+
+private:
+  struct Entry {
+    std::string          key;
+    uint16_t             format   = 0;
+    uint32_t             size     = 0;
+    uint32_t             max_size = 0;
+    std::vector<uint8_t> data;
+  };
+
+  void set(Entry entry);
+
+  std::vector<Entry> entries_;
+};
@@ -0,0 +1,261 @@
+#include "perf_compare.h"
+#include "perf_log.h"
+#include "perf_store.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void usage() {
+  printf("Usage: intest_perf record --build <name> [--run <id>] [--db <file>] <log file or folder>...\n"
+         "       intest_perf compare --new <name> [--base <name>] [--db <file>] [options]\n"
+         "       intest_perf builds [--db <file>]\n"
+         "\n"
+         "Keeps the [timing] and [bench] results of the test packages per emulator build and compares builds.\n"
+         "record reads package logs, a folder is read as the logs intest_run writes (<title id>.log). Every record\n"
+         "call is one run, record the same build several times to give compare an idea of the noise.\n"
+         "\n"
+         "Options:\n"
+         "  --db <file>           result database, a CSV file (default intest_perf.csv)\n"
+         "  --build <name>        emulator build the logs were produced with (record)\n"
+         "  --run <id>            run ID, default is the current time (record)\n"
+         "  --base <name>         build to compare against, default is the one recorded before --new\n"
+         "  --new <name>          build to check\n"
+         "  --threshold <percent> how much slower a metric may get (default 5)\n"
+         "  --noise <model>       mad, stddev or none (default mad)\n"
+         "  --sigma <k>           standard errors a change has to exceed to count (default 3)\n"
+         "  --min-runs <n>        runs per build needed to estimate the noise (default 3)\n"
+         "  --only <pattern>      only compare titles matching the glob pattern, can be repeated\n"
+         "  --exclude <pattern>   skip titles matching the glob pattern, can be repeated\n"
+         "  -v, --verbose         list every metric, not only the ones that changed\n"
+         "\n"
+         "compare exits with 1 when a metric got slower, 0 when none did and 2 for usage errors.\n");
+}
+
+struct Options {
+  std::string              command;
+  std::string              db = "intest_perf.csv";
+  std::string              build;
+  std::string              run;
+  std::string              base;
+  std::string              candidate;
+  bool                     verbose = false;
+  CompareOptions           compare;
+  std::vector<std::string> paths;
+};
+
+static bool parse_options(int argc, char** argv, Options* options) {
+  if (argc < 2) {
+    usage();
+    return false;
+  }
+  options->command = argv[1];
+  if (options->command == "-h" || options->command == "--help") {
+    usage();
+    exit(0);
+  }
+
+  for (int i = 2; i < argc; ++i) {
+    std::string arg  = argv[i];
+    auto        next = [&](const char* name) -> const char* {
+      if (i + 1 < argc) return argv[++i];
+      fprintf(stderr, "intest_perf: %s needs a value\n", name);
+      return nullptr;
+    };
+
+    const char* value = nullptr;
+    if (arg == "-h" || arg == "--help") {
+      usage();
+      exit(0);
+    } else if (arg == "--db") {
+      if ((value = next("--db")) == nullptr) return false;
+      options->db = value;
+    } else if (arg == "--build") {
+      if ((value = next("--build")) == nullptr) return false;
+      options->build = value;
+    } else if (arg == "--run") {
+      if ((value = next("--run")) == nullptr) return false;
+      options->run = value;
+    } else if (arg == "--base") {
+      if ((value = next("--base")) == nullptr) return false;
+      options->base = value;
+    } else if (arg == "--new") {
+      if ((value = next("--new")) == nullptr) return false;
+      options->candidate = value;
+    } else if (arg == "--threshold") {
+      if ((value = next("--threshold")) == nullptr) return false;
+      options->compare.threshold = strtod(value, nullptr);
+    } else if (arg == "--sigma") {
+      if ((value = next("--sigma")) == nullptr) return false;
+      options->compare.sigma = strtod(value, nullptr);
+    } else if (arg == "--min-runs") {
+      if ((value = next("--min-runs")) == nullptr) return false;
+      options->compare.min_runs = std::max(1l, strtol(value, nullptr, 10));
+    } else if (arg == "--noise") {
+      if ((value = next("--noise")) == nullptr) return false;
+      if (strcmp(value, "mad") == 0) {
+        options->compare.noise = NoiseModel::Mad;
+      } else if (strcmp(value, "stddev") == 0) {
+        options->compare.noise = NoiseModel::Stddev;
+      } else if (strcmp(value, "none") == 0) {
+        options->compare.noise = NoiseModel::None;
+      } else {
+        fprintf(stderr, "intest_perf: unknown noise model %s\n", value);
+        return false;
+      }
+    } else if (arg == "--only") {
+      if ((value = next("--only")) == nullptr) return false;
+      options->compare.only.push_back(value);
+    } else if (arg == "--exclude") {
+      if ((value = next("--exclude")) == nullptr) return false;
+      options->compare.exclude.push_back(value);
+    } else if (arg == "-v" || arg == "--verbose") {
+      options->verbose = true;
+    } else if (!arg.empty() && arg[0] == '-') {
+      fprintf(stderr, "intest_perf: unknown option %s\n", arg.c_str());
+      return false;
+    } else {
+      options->paths.push_back(arg);
+    }
+  }
+  return true;
+}
+
+// Log files to read for a path, a folder contributes its *.log files.
+static void find_logs(const std::string& path, std::vector<fs::path>* logs) {
+  std::error_code error;
+  if (!fs::is_directory(path, error)) {
+    logs->push_back(path);
+    return;
+  }
+  std::vector<fs::path> found;
+  for (const fs::directory_entry& entry: fs::directory_iterator(path, error)) {
+    if (entry.is_regular_file(error) && entry.path().extension() == ".log") found.push_back(entry.path());
+  }
+  std::sort(found.begin(), found.end());
+  logs->insert(logs->end(), found.begin(), found.end());
+}
+
+static int record(const Options& options) {
+  if (options.build.empty() || options.paths.empty()) {
+    fprintf(stderr, "intest_perf: record needs --build and at least one log\n");
+    return 2;
+  }
+
+  std::string run = options.run;
+  if (run.empty()) {
+    char      stamp[32];
+    time_t    now = time(nullptr);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%SZ", &utc);
+    run = std::string(stamp) + "-" + std::to_string(getpid());
+  }
+
+  std::vector<fs::path> logs;
+  for (const std::string& path: options.paths) {
+    find_logs(path, &logs);
+  }
+
+  std::vector<PerfRecord> records;
+  std::string             error;
+  for (const fs::path& log: logs) {
+    std::vector<PerfSample> samples;
+    if (!perf_read_log(log.string(), log.stem().string(), &samples, &error)) {
+      fprintf(stderr, "intest_perf: %s\n", error.c_str());
+      return 2;
+    }
+    if (samples.empty()) printf("%s: no [timing] or [bench] results\n", log.string().c_str());
+    for (PerfSample& sample: samples) {
+      records.push_back({options.build, run, std::move(sample)});
+    }
+  }
+
+  if (!perf_store_append(options.db, records, &error)) {
+    fprintf(stderr, "intest_perf: %s\n", error.c_str());
+    return 2;
+  }
+  printf("%zu samples from %zu logs recorded as %s run %s\n", records.size(), logs.size(), options.build.c_str(), run.c_str());
+  return 0;
+}
+
+// Builds in the order they were first recorded.
+static std::vector<std::string> recorded_builds(const std::vector<PerfRecord>& records) {
+  std::vector<std::string> builds;
+  for (const PerfRecord& record: records) {
+    if (std::find(builds.begin(), builds.end(), record.build) == builds.end()) builds.push_back(record.build);
+  }
+  return builds;
+}
+
+static int compare(const Options& options, const std::vector<PerfRecord>& records) {
+  if (options.candidate.empty()) {
+    fprintf(stderr, "intest_perf: compare needs --new\n");
+    return 2;
+  }
+
+  std::vector<std::string> builds    = recorded_builds(records);
+  auto                     candidate = std::find(builds.begin(), builds.end(), options.candidate);
+  if (candidate == builds.end()) {
+    fprintf(stderr, "intest_perf: no results for build %s in %s\n", options.candidate.c_str(), options.db.c_str());
+    return 2;
+  }
+  std::string base = options.base;
+  if (base.empty()) {
+    if (candidate == builds.begin()) {
+      fprintf(stderr, "intest_perf: %s is the first build in %s, pass --base\n", options.candidate.c_str(), options.db.c_str());
+      return 2;
+    }
+    base = *(candidate - 1);
+  } else if (std::find(builds.begin(), builds.end(), base) == builds.end()) {
+    fprintf(stderr, "intest_perf: no results for build %s in %s\n", base.c_str(), options.db.c_str());
+    return 2;
+  }
+
+  std::vector<CompareResult> results = perf_compare(records, base, options.candidate, options.compare);
+  perf_print_comparison(results, base, options.candidate, options.compare, options.verbose);
+  for (const CompareResult& result: results) {
+    if (result.status == CompareStatus::Regressed) return 1;
+  }
+  return 0;
+}
+
+static int builds(const std::vector<PerfRecord>& records) {
+  for (const std::string& build: recorded_builds(records)) {
+    std::vector<std::string> runs;
+    size_t                   samples = 0;
+    for (const PerfRecord& record: records) {
+      if (record.build != build) continue;
+      ++samples;
+      if (std::find(runs.begin(), runs.end(), record.run) == runs.end()) runs.push_back(record.run);
+    }
+    printf("%-24s %4zu runs %8zu samples\n", build.c_str(), runs.size(), samples);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, &options)) return 2;
+  if (options.command != "record" && options.command != "compare" && options.command != "builds") {
+    fprintf(stderr, "intest_perf: unknown command %s\n", options.command.c_str());
+    return 2;
+  }
+  if (options.command == "record") return record(options);
+
+  std::vector<PerfRecord> records;
+  std::string             error;
+  if (!perf_store_load(options.db, &records, &error)) {
+    fprintf(stderr, "intest_perf: %s\n", error.c_str());
+    return 2;
+  }
+  return options.command == "compare" ? compare(options, records) : builds(records);
+}
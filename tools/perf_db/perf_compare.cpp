@@ -0,0 +1,202 @@
+#include "perf_compare.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fnmatch.h>
+#include <map>
+#include <tuple>
+
+using MetricKey = std::tuple<std::string, std::string, std::string>; // title, test, metric
+
+// Samples of one metric and build, grouped by run.
+using RunSamples = std::map<std::string, std::vector<double>>;
+
+static double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t middle = values.size() / 2;
+  return values.size() % 2 != 0 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+// One value per run, a run that measured a metric several times (-r, repeated cases) counts with its median.
+// Samples from the same run aren't independent, the noise that matters is the one between runs.
+static std::vector<double> run_values(const RunSamples& runs) {
+  std::vector<double> values;
+  for (const auto& [run, samples]: runs) {
+    values.push_back(median(samples));
+  }
+  return values;
+}
+
+// Spread of the runs around the median of their build, both builds pooled.
+static double noise_sigma(NoiseModel model, const std::vector<double>& base, const std::vector<double>& candidate) {
+  std::vector<double> deviations;
+  for (const std::vector<double>* values: {&base, &candidate}) {
+    double center = median(*values);
+    for (double value: *values) {
+      deviations.push_back(value - center);
+    }
+  }
+
+  if (model == NoiseModel::Mad) {
+    for (double& deviation: deviations) {
+      deviation = std::fabs(deviation);
+    }
+    // Scales the MAD to the standard deviation of normally distributed values.
+    return 1.4826 * median(deviations);
+  }
+
+  double sum = 0;
+  for (double deviation: deviations) {
+    sum += deviation * deviation;
+  }
+  // Each build's median used up one degree of freedom.
+  return deviations.size() > 2 ? std::sqrt(sum / double(deviations.size() - 2)) : 0;
+}
+
+static bool title_selected(const CompareOptions& options, const std::string& title) {
+  for (const std::string& pattern: options.exclude) {
+    if (fnmatch(pattern.c_str(), title.c_str(), 0) == 0) return false;
+  }
+  if (options.only.empty()) return true;
+  for (const std::string& pattern: options.only) {
+    if (fnmatch(pattern.c_str(), title.c_str(), 0) == 0) return true;
+  }
+  return false;
+}
+
+std::vector<CompareResult> perf_compare(const std::vector<PerfRecord>& records, const std::string& base_build, const std::string& new_build,
+                                        const CompareOptions& options) {
+  std::map<MetricKey, RunSamples> base_samples;
+  std::map<MetricKey, RunSamples> new_samples;
+  for (const PerfRecord& record: records) {
+    if (!title_selected(options, record.sample.title)) continue;
+    MetricKey key = {record.sample.title, record.sample.test, record.sample.metric};
+    if (record.build == base_build) base_samples[key][record.run].push_back(record.sample.value);
+    if (record.build == new_build) new_samples[key][record.run].push_back(record.sample.value);
+  }
+
+  std::vector<CompareResult> results;
+  for (const auto& [key, base_runs]: base_samples) {
+    CompareResult result;
+    std::tie(result.title, result.test, result.metric) = key;
+    std::vector<double> base_values = run_values(base_runs);
+    result.base_runs                = base_values.size();
+    result.base_value               = median(base_values);
+
+    auto candidate = new_samples.find(key);
+    if (candidate == new_samples.end()) {
+      result.status = CompareStatus::Missing;
+      results.push_back(result);
+      continue;
+    }
+    std::vector<double> new_values = run_values(candidate->second);
+    result.new_runs                = new_values.size();
+    result.new_value               = median(new_values);
+    new_samples.erase(candidate);
+
+    MetricDirection direction = MetricDirection::LowerIsBetter;
+    perf_metric_direction(result.metric, &direction);
+    if (result.base_value <= 0 || result.new_value <= 0) {
+      // Nothing measurable, a rate of 0 or a case that got skipped.
+      results.push_back(result);
+      continue;
+    }
+    double ratio  = direction == MetricDirection::LowerIsBetter ? result.new_value / result.base_value : result.base_value / result.new_value;
+    result.change = (ratio - 1) * 100;
+
+    // A change is significant when it exceeds options.sigma standard errors of the difference of the two medians.
+    // Without enough runs the noise can't be estimated and only the threshold decides.
+    bool significant = true;
+    result.few_runs  = result.base_runs < options.min_runs || result.new_runs < options.min_runs;
+    if (options.noise != NoiseModel::None && !result.few_runs) {
+      double sigma = noise_sigma(options.noise, base_values, new_values);
+      double error = sigma * std::sqrt(1.0 / double(result.base_runs) + 1.0 / double(result.new_runs));
+      result.noise = error / result.base_value * 100;
+      significant  = std::fabs(result.new_value - result.base_value) > options.sigma * error;
+    }
+
+    if (significant && result.change > options.threshold) {
+      result.status = CompareStatus::Regressed;
+    } else if (significant && result.change < -options.threshold) {
+      result.status = CompareStatus::Improved;
+    }
+    results.push_back(result);
+  }
+
+  for (const auto& [key, new_runs]: new_samples) {
+    CompareResult result;
+    std::tie(result.title, result.test, result.metric) = key;
+    std::vector<double> new_values = run_values(new_runs);
+    result.status                  = CompareStatus::Added;
+    result.new_runs                = new_values.size();
+    result.new_value               = median(new_values);
+    results.push_back(result);
+  }
+
+  // Regressions first, then improvements, each with the largest change first.
+  auto rank = [](CompareStatus status) {
+    switch (status) {
+      case CompareStatus::Regressed: return 0;
+      case CompareStatus::Improved: return 1;
+      case CompareStatus::Unchanged: return 2;
+      case CompareStatus::Missing: return 3;
+      case CompareStatus::Added: return 4;
+    }
+    return 5;
+  };
+  std::stable_sort(results.begin(), results.end(), [&](const CompareResult& a, const CompareResult& b) {
+    if (a.status != b.status) return rank(a.status) < rank(b.status);
+    return a.status == CompareStatus::Improved ? a.change < b.change : a.change > b.change;
+  });
+  return results;
+}
+
+static const char* compare_status_name(CompareStatus status) {
+  switch (status) {
+    case CompareStatus::Unchanged: return "same";
+    case CompareStatus::Regressed: return "SLOWER";
+    case CompareStatus::Improved: return "faster";
+    case CompareStatus::Missing: return "missing";
+    case CompareStatus::Added: return "added";
+  }
+  return "?";
+}
+
+void perf_print_comparison(const std::vector<CompareResult>& results, const std::string& base_build, const std::string& new_build,
+                           const CompareOptions& options, bool verbose) {
+  size_t counts[5] = {};
+  size_t few_runs  = 0;
+  for (const CompareResult& result: results) {
+    counts[size_t(result.status)]++;
+    few_runs += result.few_runs ? 1 : 0;
+  }
+
+  printf("%s -> %s, threshold %.1f%%", base_build.c_str(), new_build.c_str(), options.threshold);
+  if (options.noise != NoiseModel::None) printf(", significance %.1f sigma (%s)", options.sigma, options.noise == NoiseModel::Mad ? "mad" : "stddev");
+  printf("\n\n");
+
+  bool header = false;
+  for (const CompareResult& result: results) {
+    bool changed = result.status == CompareStatus::Regressed || result.status == CompareStatus::Improved;
+    if (!verbose && !changed) continue;
+    if (!header) {
+      printf("%-10s %-7s %8s %8s %14s %14s  %-s\n", "title", "status", "change", "noise", "base", "new", "test metric (runs)");
+      header = true;
+    }
+
+    char change[16] = "-";
+    char noise[16]  = "-";
+    if (result.status != CompareStatus::Missing && result.status != CompareStatus::Added) snprintf(change, sizeof(change), "%+.1f%%", result.change);
+    if (result.noise > 0) snprintf(noise, sizeof(noise), "%.1f%%", result.noise);
+    printf("%-10s %-7s %8s %8s %14.6g %14.6g  %s %s (%zu/%zu)%s\n", result.title.c_str(), compare_status_name(result.status), change, noise, result.base_value,
+           result.new_value, result.test.c_str(), result.metric.c_str(), result.base_runs, result.new_runs, result.few_runs ? " few runs" : "");
+  }
+  if (header) printf("\n");
+
+  printf("%zu slower, %zu faster, %zu unchanged, %zu missing, %zu added\n", counts[size_t(CompareStatus::Regressed)], counts[size_t(CompareStatus::Improved)],
+         counts[size_t(CompareStatus::Unchanged)], counts[size_t(CompareStatus::Missing)], counts[size_t(CompareStatus::Added)]);
+  if (few_runs > 0 && options.noise != NoiseModel::None) {
+    printf("%zu metrics have less than %zu runs with a build, only the threshold was applied to them\n", few_runs, options.min_runs);
+  }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "perf_store.h"
+
+#include <string>
+#include <vector>
+
+enum class NoiseModel {
+  Mad,    // Median absolute deviation of the runs, robust against single outliers
+  Stddev, // Standard deviation of the runs
+  None,   // No noise estimate, every change past the threshold counts
+};
+
+struct CompareOptions {
+  double                   threshold = 5; // Percent a metric has to get worse to be a regression
+  double                   sigma     = 3; // How many standard errors a change has to exceed to be significant
+  NoiseModel               noise     = NoiseModel::Mad;
+  size_t                   min_runs  = 3; // Below this on either side the noise can't be estimated, only the threshold applies
+  std::vector<std::string> only;          // Title ID patterns
+  std::vector<std::string> exclude;
+};
+
+enum class CompareStatus {
+  Unchanged,
+  Regressed,
+  Improved,
+  Missing, // Only measured with the base build
+  Added,   // Only measured with the new build
+};
+
+struct CompareResult {
+  std::string   title;
+  std::string   test;
+  std::string   metric;
+  CompareStatus status     = CompareStatus::Unchanged;
+  size_t        base_runs  = 0;
+  size_t        new_runs   = 0;
+  double        base_value = 0; // Median of the runs, a run with several samples counts with its median
+  double        new_value  = 0;
+  double        change     = 0; // Percent the metric got worse, negative when it got better
+  double        noise      = 0; // Standard error of the change in percent of the base value, 0 without noise estimate
+  bool          few_runs   = false;
+};
+
+// Compares every metric measured with both builds.
+std::vector<CompareResult> perf_compare(const std::vector<PerfRecord>& records, const std::string& base_build, const std::string& new_build,
+                                        const CompareOptions& options);
+
+// Prints the regressions and improvements, all metrics when verbose is set, followed by the counts.
+void perf_print_comparison(const std::vector<CompareResult>& results, const std::string& base_build, const std::string& new_build,
+                           const CompareOptions& options, bool verbose);
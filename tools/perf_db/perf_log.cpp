@@ -0,0 +1,238 @@
+#include "perf_log.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+// Just enough JSON for the [timing] line.
+struct JsonValue {
+  enum class Type { Null, Bool, Number, String, Array, Object };
+
+  Type                                           type    = Type::Null;
+  bool                                           boolean = false;
+  double                                         number  = 0;
+  std::string                                    string;
+  std::vector<JsonValue>                         items;
+  std::vector<std::pair<std::string, JsonValue>> members;
+
+  const JsonValue* get(const char* name) const {
+    for (const auto& [key, value]: members) {
+      if (key == name) return &value;
+    }
+    return nullptr;
+  }
+};
+
+class JsonParser {
+public:
+  explicit JsonParser(const std::string& text): text_(text) {}
+
+  bool parse(JsonValue* value) {
+    if (!parse_value(value, 0)) return false;
+    skip_space();
+    return pos_ == text_.size();
+  }
+
+private:
+  void skip_space() {
+    while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r' || text_[pos_] == '\n')) {
+      ++pos_;
+    }
+  }
+
+  bool consume(char c) {
+    skip_space();
+    if (pos_ == text_.size() || text_[pos_] != c) return false;
+    ++pos_;
+    return true;
+  }
+
+  bool parse_literal(const char* literal) {
+    size_t size = strlen(literal);
+    if (text_.compare(pos_, size, literal) != 0) return false;
+    pos_ += size;
+    return true;
+  }
+
+  bool parse_string(std::string* out) {
+    if (!consume('"')) return false;
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+      char c = text_[pos_++];
+      if (c == '\\') {
+        if (pos_ == text_.size()) return false;
+        c = text_[pos_++];
+        switch (c) {
+          case 'n': c = '\n'; break;
+          case 't': c = '\t'; break;
+          case 'r': c = '\r'; break;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'u':
+            // Not produced by the runner, kept as is.
+            out->append("\\u");
+            continue;
+          default: break;
+        }
+      }
+      *out += c;
+    }
+    return consume('"');
+  }
+
+  bool parse_value(JsonValue* value, int depth) {
+    if (depth > 32) return false;
+    skip_space();
+    if (pos_ == text_.size()) return false;
+
+    char c = text_[pos_];
+    if (c == '{') {
+      ++pos_;
+      value->type = JsonValue::Type::Object;
+      if (consume('}')) return true;
+      do {
+        std::pair<std::string, JsonValue> member;
+        if (!parse_string(&member.first) || !consume(':') || !parse_value(&member.second, depth + 1)) return false;
+        value->members.push_back(std::move(member));
+      } while (consume(','));
+      return consume('}');
+    }
+    if (c == '[') {
+      ++pos_;
+      value->type = JsonValue::Type::Array;
+      if (consume(']')) return true;
+      do {
+        value->items.emplace_back();
+        if (!parse_value(&value->items.back(), depth + 1)) return false;
+      } while (consume(','));
+      return consume(']');
+    }
+    if (c == '"') {
+      value->type = JsonValue::Type::String;
+      return parse_string(&value->string);
+    }
+    if (parse_literal("true") || parse_literal("false")) {
+      value->type    = JsonValue::Type::Bool;
+      value->boolean = c == 't';
+      return true;
+    }
+    if (parse_literal("null")) return true;
+
+    const char* start = text_.c_str() + pos_;
+    char*       end   = nullptr;
+    value->type       = JsonValue::Type::Number;
+    value->number     = strtod(start, &end);
+    if (end == start) return false;
+    pos_ += end - start;
+    return true;
+  }
+
+  const std::string& text_;
+  size_t             pos_ = 0;
+};
+
+static bool ends_with(const std::string& text, const char* suffix) {
+  size_t size = strlen(suffix);
+  return text.size() >= size && text.compare(text.size() - size, size, suffix) == 0;
+}
+
+// [timing] {"title_id":"...","process_time_us":...,"tests":[{"group":"...","name":"...",...,"duration_ns":...,"passed":true},...]}
+static bool parse_timing(const std::string& json, std::string* title, std::vector<PerfSample>* samples) {
+  JsonValue  root;
+  JsonParser parser(json);
+  if (!parser.parse(&root) || root.type != JsonValue::Type::Object) return false;
+
+  const JsonValue* title_id = root.get("title_id");
+  if (title_id != nullptr && title_id->type == JsonValue::Type::String) *title = title_id->string;
+
+  const JsonValue* tests = root.get("tests");
+  if (tests == nullptr || tests->type != JsonValue::Type::Array) return false;
+  for (const JsonValue& test: tests->items) {
+    const JsonValue* group    = test.get("group");
+    const JsonValue* name     = test.get("name");
+    const JsonValue* duration = test.get("duration_ns");
+    const JsonValue* passed   = test.get("passed");
+    if (group == nullptr || name == nullptr || duration == nullptr || duration->type != JsonValue::Type::Number) continue;
+    if (passed == nullptr || !passed->boolean) continue;
+
+    PerfSample sample;
+    sample.test   = group->string + "/" + name->string;
+    sample.metric = "duration_ns";
+    sample.value  = duration->number;
+    samples->push_back(sample);
+  }
+  return true;
+}
+
+// [bench] <suite>/<case> key=value key=value ...
+static void parse_bench(const std::string& line, std::vector<PerfSample>* samples) {
+  size_t name_end = line.find(' ');
+  if (name_end == std::string::npos) return;
+  std::string test = line.substr(0, name_end);
+
+  size_t pos = name_end;
+  while (pos < line.size()) {
+    size_t start = line.find_first_not_of(' ', pos);
+    if (start == std::string::npos) break;
+    size_t end = line.find(' ', start);
+    if (end == std::string::npos) end = line.size();
+    pos = end;
+
+    size_t equals = line.find('=', start);
+    if (equals == std::string::npos || equals > end) continue;
+    std::string     key = line.substr(start, equals - start);
+    MetricDirection direction;
+    if (!perf_metric_direction(key, &direction)) continue;
+
+    std::string value  = line.substr(equals + 1, end - equals - 1);
+    char*       number = nullptr;
+    PerfSample  sample;
+    sample.test   = test;
+    sample.metric = key;
+    sample.value  = strtod(value.c_str(), &number);
+    if (number != value.c_str() && *number == '\0') samples->push_back(sample);
+  }
+}
+
+bool perf_metric_direction(const std::string& metric, MetricDirection* direction) {
+  if (ends_with(metric, "_ns") || ends_with(metric, "_us") || ends_with(metric, "_ms") || metric.compare(0, 7, "ns_per_") == 0) {
+    *direction = MetricDirection::LowerIsBetter;
+    return true;
+  }
+  if (ends_with(metric, "_per_sec") || ends_with(metric, "_gbps") || ends_with(metric, "efficiency")) {
+    *direction = MetricDirection::HigherIsBetter;
+    return true;
+  }
+  return false;
+}
+
+bool perf_read_log(const std::string& path, const std::string& default_title, std::vector<PerfSample>* samples, std::string* error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    *error = path + ": " + strerror(errno);
+    return false;
+  }
+
+  // [bench] lines come before the [timing] line, the title is only known at the end.
+  std::vector<PerfSample> found;
+  std::string             title = default_title;
+  std::string             line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    // Emulators may put their own log prefix in front of guest output.
+    size_t tag = line.find("[timing] ");
+    if (tag != std::string::npos) {
+      parse_timing(line.substr(tag + 9), &title, &found);
+      continue;
+    }
+    tag = line.find("[bench] ");
+    if (tag != std::string::npos) parse_bench(line.substr(tag + 8), &found);
+  }
+
+  for (PerfSample& sample: found) {
+    sample.title = title;
+    samples->push_back(std::move(sample));
+  }
+  return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+enum class MetricDirection {
+  LowerIsBetter,  // Durations and latencies, *_ns, *_us, ns_per_*, ...
+  HigherIsBetter, // Rates, *_per_sec, *_gbps, ...
+};
+
+// One measurement from a package log.
+struct PerfSample {
+  std::string title;  // Title ID of the package
+  std::string test;   // "Group/Name" for [timing], "<suite>/<case>" for [bench]
+  std::string metric; // "duration_ns" for [timing], the key of a key=value pair for [bench]
+  double      value = 0;
+};
+
+// Direction of a metric from its name. Returns false for keys that aren't measurements (counts, sizes, seeds, ...),
+// those are not recorded.
+bool perf_metric_direction(const std::string& metric, MetricDirection* direction);
+
+// Reads the [timing] and [bench] lines from the output of one package, see tests/common/timing_plugin.h and
+// tests/common/bench.h. The title ID comes from the [timing] line, default_title is used when the
+// log has none. Only passed tests are taken from [timing], a failed test didn't necessarily run to the end.
+bool perf_read_log(const std::string& path, const std::string& default_title, std::vector<PerfSample>* samples, std::string* error);
@@ -0,0 +1,121 @@
+#include "perf_store.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+static const char* const perf_store_header = "build,run,title_id,test,metric,value";
+
+static void csv_append_field(std::string& out, const std::string& field) {
+  if (field.find_first_of(",\"\r\n") == std::string::npos) {
+    out += field;
+    return;
+  }
+  out += '"';
+  for (char c: field) {
+    if (c == '"') out += '"';
+    out += c;
+  }
+  out += '"';
+}
+
+// Splits one line, quoted fields can't span lines here since fields with line breaks never get written.
+static bool csv_split(const std::string& line, std::vector<std::string>* fields) {
+  fields->clear();
+  std::string field;
+  bool        quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (quoted) {
+      if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+        field += '"';
+        ++i;
+      } else if (c == '"') {
+        quoted = false;
+      } else {
+        field += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields->push_back(field);
+      field.clear();
+    } else {
+      field += c;
+    }
+  }
+  fields->push_back(field);
+  return !quoted;
+}
+
+bool perf_store_load(const std::string& path, std::vector<PerfRecord>* records, std::string* error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    if (errno == ENOENT) return true;
+    *error = path + ": " + strerror(errno);
+    return false;
+  }
+
+  std::string              line;
+  std::vector<std::string> fields;
+  size_t                   line_number = 0;
+  while (std::getline(file, line)) {
+    ++line_number;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty() || (line_number == 1 && line == perf_store_header)) continue;
+
+    char* end = nullptr;
+    if (!csv_split(line, &fields) || fields.size() != 6) {
+      *error = path + ":" + std::to_string(line_number) + ": expected " + perf_store_header;
+      return false;
+    }
+    PerfRecord record;
+    record.build         = fields[0];
+    record.run           = fields[1];
+    record.sample.title  = fields[2];
+    record.sample.test   = fields[3];
+    record.sample.metric = fields[4];
+    record.sample.value  = strtod(fields[5].c_str(), &end);
+    if (end == fields[5].c_str()) {
+      *error = path + ":" + std::to_string(line_number) + ": bad value " + fields[5];
+      return false;
+    }
+    records->push_back(std::move(record));
+  }
+  return true;
+}
+
+bool perf_store_append(const std::string& path, const std::vector<PerfRecord>& records, std::string* error) {
+  bool        exists = std::ifstream(path).good();
+  std::string text;
+  char        number[32];
+  if (!exists) {
+    text += perf_store_header;
+    text += '\n';
+  }
+  for (const PerfRecord& record: records) {
+    csv_append_field(text, record.build);
+    text += ',';
+    csv_append_field(text, record.run);
+    text += ',';
+    csv_append_field(text, record.sample.title);
+    text += ',';
+    csv_append_field(text, record.sample.test);
+    text += ',';
+    csv_append_field(text, record.sample.metric);
+    snprintf(number, sizeof(number), ",%.10g\n", record.sample.value);
+    text += number;
+  }
+
+  FILE* file = fopen(path.c_str(), "ab");
+  if (file == nullptr) {
+    *error = path + ": " + strerror(errno);
+    return false;
+  }
+  bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+  written      = fclose(file) == 0 && written;
+  if (!written) *error = path + ": write failed";
+  return written;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "perf_log.h"
+
+#include <string>
+#include <vector>
+
+// A sample as it is kept in the database, a CSV file with one sample per line:
+// build,run,title_id,test,metric,value
+struct PerfRecord {
+  std::string build; // Emulator build the sample was measured with, any string (version, commit, ...)
+  std::string run;   // Samples recorded together share a run, runs of the same build are repeated measurements
+  PerfSample  sample;
+};
+
+// A missing file is an empty database.
+bool perf_store_load(const std::string& path, std::vector<PerfRecord>* records, std::string* error);
+
+// Appends to the file, creating it with the header line if needed.
+bool perf_store_append(const std::string& path, const std::vector<PerfRecord>& records, std::string* error);
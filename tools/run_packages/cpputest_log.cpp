@@ -0,0 +1,93 @@
+#include "cpputest_log.h"
+
+#include <cstdlib>
+#include <cstring>
+
+CppUTestLog::CppUTestLog(std::function<void(const std::string&)> on_line): on_line_(std::move(on_line)) {}
+
+void CppUTestLog::feed(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (data[i] == '\n') {
+      line(partial_);
+      partial_.clear();
+    } else if (data[i] != '\r') {
+      partial_ += data[i];
+    }
+  }
+}
+
+void CppUTestLog::finish() {
+  if (partial_.empty()) return;
+  line(partial_);
+  partial_.clear();
+}
+
+void CppUTestLog::line(const std::string& text) {
+  if (on_line_) on_line_(text);
+
+  // <file>:<line>: error: Failure in TEST(Group, Name)
+  size_t failure = text.find(": error: Failure in TEST(");
+  if (failure != std::string::npos) {
+    size_t test_end = text.find(')', failure);
+    failures_.push_back(text.substr(failure + 20, test_end - failure - 19) + " at " + text.substr(0, failure));
+    return;
+  }
+
+  if (text.compare(0, 10, "[watchdog]") == 0) {
+    watchdog_.push_back(text);
+    return;
+  }
+
+  TestSummary summary;
+  if (cpputest_parse_summary(text, &summary)) summary_ = summary;
+}
+
+bool cpputest_parse_summary(const std::string& text, TestSummary* summary) {
+  TestSummary result;
+  size_t      pos = 0;
+  if (text.compare(0, 4, "OK (") == 0) {
+    result.ok = true;
+    pos       = 4;
+  } else if (text.compare(0, 8, "Errors (") == 0) {
+    pos = 8;
+  } else {
+    return false;
+  }
+
+  // Comma separated "<count> <name>" pairs, newer versions put "ran nothing" first when no test ran.
+  bool any = false;
+  while (pos < text.size() && text[pos] != ')') {
+    size_t end = text.find_first_of(",)", pos);
+    if (end == std::string::npos) return false;
+    std::string item = text.substr(pos, end - pos);
+    pos              = end + (text[end] == ',' ? 1 : 0);
+    while (pos < text.size() && text[pos] == ' ') ++pos;
+
+    char*   name  = nullptr;
+    int64_t value = strtoll(item.c_str(), &name, 10);
+    if (name == item.c_str()) continue;
+    while (*name == ' ') ++name;
+
+    any = true;
+    if (strcmp(name, "failures") == 0 || strcmp(name, "failure") == 0) {
+      result.failures = int32_t(value);
+    } else if (strcmp(name, "tests") == 0 || strcmp(name, "test") == 0) {
+      result.tests = int32_t(value);
+    } else if (strcmp(name, "ran") == 0) {
+      result.ran = int32_t(value);
+    } else if (strcmp(name, "checks") == 0 || strcmp(name, "check") == 0) {
+      result.checks = int32_t(value);
+    } else if (strcmp(name, "ignored") == 0) {
+      result.ignored = int32_t(value);
+    } else if (strcmp(name, "filtered out") == 0) {
+      result.filtered_out = int32_t(value);
+    } else if (strcmp(name, "ms") == 0) {
+      result.ms = value;
+    }
+  }
+  if (!any) return false;
+
+  result.found = true;
+  *summary     = result;
+  return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Counts from the line CppUTest prints after the last test:
+// OK (12 tests, 12 ran, 345 checks, 0 ignored, 0 filtered out, 1234 ms)
+// Errors (1 failures, 12 tests, 12 ran, 345 checks, 0 ignored, 0 filtered out, 1234 ms)
+struct TestSummary {
+  bool    found        = false;
+  bool    ok           = false;
+  int32_t failures     = 0;
+  int32_t tests        = 0;
+  int32_t ran          = 0;
+  int32_t checks       = 0;
+  int32_t ignored      = 0;
+  int32_t filtered_out = 0;
+  int64_t ms           = 0;
+};
+
+// Collects what the report needs from a package's output while it is being read.
+class CppUTestLog {
+public:
+  // Called for every complete line, without the line break.
+  explicit CppUTestLog(std::function<void(const std::string&)> on_line = nullptr);
+
+  void feed(const char* data, size_t size);
+  // Handles a last line without line break.
+  void finish();
+
+  const TestSummary&              summary() const { return summary_; }
+  const std::vector<std::string>& failures() const { return failures_; }
+  const std::vector<std::string>& watchdog() const { return watchdog_; }
+
+private:
+  void line(const std::string& text);
+
+  std::function<void(const std::string&)> on_line_;
+  std::string                             partial_;
+  TestSummary                             summary_;
+  std::vector<std::string>                failures_; // "TEST(Group, Name) at file:line"
+  std::vector<std::string>                watchdog_; // "[watchdog]" lines of the runner, see tests/common/watchdog.h
+};
+
+// Parses a CppUTest summary line, returns false if text isn't one.
+bool cpputest_parse_summary(const std::string& text, TestSummary* summary);
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Stand-in for an emulator to try intest_run without one:
+#   intest_run ./build/install -- ./tools/run_packages/fake_emulator.sh {dir}
+# Prints CppUTest-style output for the package folder it gets. FAKE_FAIL, FAKE_CRASH and FAKE_HANG take a title ID
+# pattern (shell case syntax) and make matching packages fail a test, exit without a summary or never finish.
+dir="$1"
+title=$(basename "$dir")
+
+echo "Loading $dir/eboot.bin"
+echo "TEST(FakeTests, Run)"
+
+case "$title" in
+  ${FAKE_HANG:-_none_})
+    echo "[watchdog] pretending to hang"
+    while true; do sleep 1; done
+    ;;
+  ${FAKE_CRASH:-_none_})
+    echo "Segmentation fault"
+    exit 139
+    ;;
+  ${FAKE_FAIL:-_none_})
+    echo ""
+    echo "$dir/code/test.cpp:42: error: Failure in TEST(FakeTests, Run)"
+    echo "	expected <0x00000000>"
+    echo "	but was  <0x80020016>"
+    echo ""
+    echo "Errors (1 failures, 3 tests, 3 ran, 10 checks, 0 ignored, 0 filtered out, 12 ms)"
+    exit 1
+    ;;
+esac
+
+echo ""
+echo "OK (3 tests, 3 ran, 10 checks, 0 ignored, 0 filtered out, 12 ms)"
+echo "[timing] {\"title_id\":\"$title\",\"process_time_us\":1,\"tests\":[]}"
@@ -0,0 +1,347 @@
+#include "cpputest_log.h"
+#include "process.h"
+#include "report.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fnmatch.h>
+#include <memory>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock  = std::chrono::steady_clock;
+
+struct Options {
+  size_t                   jobs        = 1;
+  double                   timeout     = 1800;
+  double                   grace       = 10;
+  double                   kill_delay  = 5;
+  std::string              log_dir     = "intest_logs";
+  std::string              json_path;
+  bool                     verbose = false;
+  std::vector<std::string> only;
+  std::vector<std::string> exclude;
+  std::vector<std::string> paths;
+  std::vector<std::string> command;
+};
+
+struct Job {
+  PackageResult                result;
+  Process                      process;
+  std::unique_ptr<CppUTestLog> log;
+  FILE*                        log_file = nullptr;
+  Clock::time_point            start;
+  Clock::time_point            summary_time;
+  Clock::time_point            kill_time;
+  Clock::time_point            drain_until;
+  bool                         terminated = false; // SIGTERM sent
+  bool                         timed_out  = false;
+  bool                         draining   = false;
+};
+
+static void usage() {
+  printf("Usage: intest_run [options] <install dir or package dir>... -- <emulator command>...\n"
+         "\n"
+         "Runs every package (a folder with an eboot.bin) below the given folders with the emulator command, several at once,\n"
+         "and prints a report from the CppUTest output. In the command {dir} is replaced with the package folder, {eboot} with\n"
+         "its eboot.bin, {title} with the title ID and {suite} with the folder above it. Without any of them the package folder\n"
+         "is added as the last argument.\n"
+         "\n"
+         "Options:\n"
+         "  -j, --jobs <n>        packages to run at once (default: number of CPUs)\n"
+         "  --timeout <seconds>   kill a package that runs longer than this (default 1800)\n"
+         "  --grace <seconds>     time an emulator gets to exit by itself after the tests finished (default 10)\n"
+         "  --only <pattern>      only run titles matching the glob pattern, can be repeated\n"
+         "  --exclude <pattern>   skip titles matching the glob pattern, can be repeated\n"
+         "  --log-dir <dir>       where the output of every package goes (default intest_logs)\n"
+         "  --json <file>         also write the report as JSON\n"
+         "  -v, --verbose         echo the output of all packages, prefixed with the title ID\n"
+         "\n"
+         "Exit code is 0 when all packages passed, 1 when one did not and 2 for usage errors.\n");
+}
+
+static bool parse_options(int argc, char** argv, Options* options) {
+  options->jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  int i = 1;
+  for (; i < argc; ++i) {
+    std::string arg  = argv[i];
+    auto        next = [&](const char* name) -> const char* {
+      if (i + 1 < argc) return argv[++i];
+      fprintf(stderr, "intest_run: %s needs a value\n", name);
+      return nullptr;
+    };
+
+    const char* value = nullptr;
+    if (arg == "--") {
+      ++i;
+      break;
+    } else if (arg == "-h" || arg == "--help") {
+      usage();
+      exit(0);
+    } else if (arg == "-j" || arg == "--jobs") {
+      if ((value = next("--jobs")) == nullptr) return false;
+      options->jobs = std::max(1l, strtol(value, nullptr, 10));
+    } else if (arg == "--timeout") {
+      if ((value = next("--timeout")) == nullptr) return false;
+      options->timeout = strtod(value, nullptr);
+    } else if (arg == "--grace") {
+      if ((value = next("--grace")) == nullptr) return false;
+      options->grace = strtod(value, nullptr);
+    } else if (arg == "--only") {
+      if ((value = next("--only")) == nullptr) return false;
+      options->only.push_back(value);
+    } else if (arg == "--exclude") {
+      if ((value = next("--exclude")) == nullptr) return false;
+      options->exclude.push_back(value);
+    } else if (arg == "--log-dir") {
+      if ((value = next("--log-dir")) == nullptr) return false;
+      options->log_dir = value;
+    } else if (arg == "--json") {
+      if ((value = next("--json")) == nullptr) return false;
+      options->json_path = value;
+    } else if (arg == "-v" || arg == "--verbose") {
+      options->verbose = true;
+    } else if (!arg.empty() && arg[0] == '-') {
+      fprintf(stderr, "intest_run: unknown option %s\n", arg.c_str());
+      return false;
+    } else {
+      options->paths.push_back(arg);
+    }
+  }
+  for (; i < argc; ++i) {
+    options->command.push_back(argv[i]);
+  }
+
+  if (options->paths.empty() || options->command.empty()) {
+    usage();
+    return false;
+  }
+  return true;
+}
+
+static bool title_selected(const Options& options, const std::string& title) {
+  for (const std::string& pattern: options.exclude) {
+    if (fnmatch(pattern.c_str(), title.c_str(), 0) == 0) return false;
+  }
+  if (options.only.empty()) return true;
+  for (const std::string& pattern: options.only) {
+    if (fnmatch(pattern.c_str(), title.c_str(), 0) == 0) return true;
+  }
+  return false;
+}
+
+// Accepts the install dir (install/<suite>/<title>), a suite folder or a package folder.
+static void find_packages(const Options& options, const fs::path& path, int depth, std::vector<PackageResult>* packages) {
+  std::error_code error;
+  if (fs::exists(path / "eboot.bin", error)) {
+    PackageResult result;
+    fs::path      dir = fs::absolute(path, error).lexically_normal();
+    if (!dir.has_filename()) dir = dir.parent_path();
+    result.title = dir.filename().string();
+    result.suite = dir.parent_path().filename().string();
+    result.dir   = dir.string();
+    if (title_selected(options, result.title)) packages->push_back(result);
+    return;
+  }
+  if (depth == 0 || !fs::is_directory(path, error)) return;
+
+  std::vector<fs::path> children;
+  for (const fs::directory_entry& entry: fs::directory_iterator(path, error)) {
+    if (entry.is_directory(error)) children.push_back(entry.path());
+  }
+  std::sort(children.begin(), children.end());
+  for (const fs::path& child: children) {
+    find_packages(options, child, depth - 1, packages);
+  }
+}
+
+static std::vector<std::string> build_command(const Options& options, const PackageResult& package) {
+  const std::pair<std::string, std::string> placeholders[] = {
+      {"{dir}", package.dir}, {"{eboot}", package.dir + "/eboot.bin"}, {"{title}", package.title}, {"{suite}", package.suite}};
+
+  std::vector<std::string> command;
+  bool                     replaced = false;
+  for (std::string arg: options.command) {
+    for (const auto& [name, value]: placeholders) {
+      for (size_t pos = arg.find(name); pos != std::string::npos; pos = arg.find(name, pos + value.size())) {
+        arg.replace(pos, name.size(), value);
+        replaced = true;
+      }
+    }
+    command.push_back(arg);
+  }
+  if (!replaced) command.push_back(package.dir);
+  return command;
+}
+
+static double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void start_job(const Options& options, Job* job) {
+  std::string log_path = options.log_dir + "/" + job->result.title + ".log";
+  job->result.log      = log_path;
+  job->start           = Clock::now();
+  job->log_file        = fopen(log_path.c_str(), "wb");
+  if (job->log_file == nullptr) fprintf(stderr, "intest_run: can't write %s: %s\n", log_path.c_str(), strerror(errno));
+
+  std::string title = job->result.title;
+  bool        echo  = options.verbose;
+  job->log          = std::make_unique<CppUTestLog>([title, echo](const std::string& line) {
+    if (echo) printf("[%s] %s\n", title.c_str(), line.c_str());
+  });
+
+  std::vector<std::string> command = build_command(options, job->result);
+  if (!process_start(command, &job->process, &job->result.error)) {
+    job->process.exited = true;
+    job->process.status = 127 << 8;
+  }
+}
+
+static void finish_job(Job* job) {
+  job->log->finish();
+  if (job->log_file != nullptr) fclose(job->log_file);
+  job->log_file = nullptr;
+
+  PackageResult& result = job->result;
+  result.seconds        = seconds_since(job->start);
+  result.summary        = job->log->summary();
+  result.failures       = job->log->failures();
+  result.watchdog       = job->log->watchdog();
+  result.exit_code      = process_exit_code(job->process);
+
+  if (!result.error.empty()) {
+    result.status = PackageStatus::Error;
+  } else if (result.summary.found) {
+    // Killing the emulator after the grace period is expected, the summary decides.
+    result.status = result.summary.ok && result.summary.failures == 0 ? PackageStatus::Passed : PackageStatus::Failed;
+  } else if (job->timed_out) {
+    result.status = PackageStatus::Timeout;
+  } else if (!result.watchdog.empty()) {
+    result.status = PackageStatus::Watchdog;
+  } else {
+    result.status = PackageStatus::Crashed;
+  }
+}
+
+// Reads output, enforces the timeout and the grace period. Returns true once the job is done.
+static bool update_job(const Options& options, Job* job) {
+  char buf[0x10000];
+  while (true) {
+    ssize_t size = process_read(&job->process, buf, sizeof(buf));
+    if (size <= 0) break;
+    if (job->log_file != nullptr) fwrite(buf, 1, size_t(size), job->log_file);
+    bool had_summary = job->log->summary().found;
+    job->log->feed(buf, size_t(size));
+    if (!had_summary && job->log->summary().found) job->summary_time = Clock::now();
+  }
+
+  Clock::time_point now = Clock::now();
+  if (!job->terminated) {
+    bool timeout = seconds_since(job->start) > options.timeout;
+    bool done    = job->log->summary().found && std::chrono::duration<double>(now - job->summary_time).count() > options.grace;
+    if (timeout || done) {
+      job->timed_out  = timeout && !done;
+      job->terminated = true;
+      job->kill_time  = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.kill_delay));
+      process_kill(job->process, SIGTERM);
+    }
+  } else if (now > job->kill_time && !job->process.exited) {
+    process_kill(job->process, SIGKILL);
+  }
+
+  if (!process_check_exit(&job->process)) return false;
+  if (job->process.fd < 0) return true;
+
+  // Something the emulator started may keep the pipe open after it exited, read what comes in a second and stop.
+  if (!job->draining) {
+    job->draining    = true;
+    job->drain_until = now + std::chrono::seconds(1);
+  } else if (now > job->drain_until) {
+    close(job->process.fd);
+    job->process.fd = -1;
+    return true;
+  }
+  return false;
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, &options)) return 2;
+
+  std::vector<PackageResult> packages;
+  for (const std::string& path: options.paths) {
+    find_packages(options, path, 2, &packages);
+  }
+  if (packages.empty()) {
+    fprintf(stderr, "intest_run: no packages found\n");
+    return 2;
+  }
+
+  std::error_code error;
+  fs::create_directories(options.log_dir, error);
+  if (error) {
+    fprintf(stderr, "intest_run: can't create %s: %s\n", options.log_dir.c_str(), error.message().c_str());
+    return 2;
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  printf("Running %zu packages, %zu at once\n", packages.size(), options.jobs);
+  Clock::time_point                 run_start = Clock::now();
+  std::vector<PackageResult>        results;
+  std::vector<std::unique_ptr<Job>> running;
+  size_t                            next = 0;
+  while (next < packages.size() || !running.empty()) {
+    while (next < packages.size() && running.size() < options.jobs) {
+      auto job    = std::make_unique<Job>();
+      job->result = packages[next++];
+      start_job(options, job.get());
+      running.push_back(std::move(job));
+    }
+
+    std::vector<pollfd> fds;
+    for (const auto& job: running) {
+      if (job->process.fd >= 0) fds.push_back({job->process.fd, POLLIN, 0});
+    }
+    poll(fds.data(), fds.size(), 100);
+
+    for (size_t i = 0; i < running.size();) {
+      Job* job = running[i].get();
+      if (!update_job(options, job)) {
+        ++i;
+        continue;
+      }
+      finish_job(job);
+      results.push_back(job->result);
+      printf("[%zu/%zu] %-10s %-8s %d tests, %d failures, %.1fs\n", results.size(), packages.size(), job->result.title.c_str(),
+             package_status_name(job->result.status), job->result.summary.tests, job->result.summary.failures, job->result.seconds);
+      running.erase(running.begin() + i);
+    }
+  }
+
+  // Results come in the order packages finished, the report is easier to compare between runs in title order.
+  std::sort(results.begin(), results.end(), [](const PackageResult& a, const PackageResult& b) {
+    return a.suite != b.suite ? a.suite < b.suite : a.title < b.title;
+  });
+  double seconds = seconds_since(run_start);
+  report_print(results, seconds);
+  if (!options.json_path.empty() && !report_write_json(results, seconds, options.json_path)) {
+    fprintf(stderr, "intest_run: can't write %s\n", options.json_path.c_str());
+  }
+
+  for (const PackageResult& result: results) {
+    if (result.status != PackageStatus::Passed) return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include "process.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+bool process_start(const std::vector<std::string>& argv, Process* process, std::string* error) {
+  int pipe_fds[2];
+  if (pipe(pipe_fds) != 0) {
+    *error = std::string("pipe: ") + strerror(errno);
+    return false;
+  }
+
+  // Reported through a second pipe that closes on exec, so exec failures don't look like an emulator that printed nothing.
+  int exec_fds[2];
+  if (pipe2(exec_fds, O_CLOEXEC) != 0) {
+    *error = std::string("pipe: ") + strerror(errno);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    return false;
+  }
+
+  std::vector<char*> args;
+  for (const std::string& arg: argv) {
+    args.push_back(const_cast<char*>(arg.c_str()));
+  }
+  args.push_back(nullptr);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    *error = std::string("fork: ") + strerror(errno);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(exec_fds[0]);
+    close(exec_fds[1]);
+    return false;
+  }
+
+  if (pid == 0) {
+    setpgid(0, 0);
+    int null_fd = open("/dev/null", O_RDONLY);
+    dup2(null_fd, STDIN_FILENO);
+    dup2(pipe_fds[1], STDOUT_FILENO);
+    dup2(pipe_fds[1], STDERR_FILENO);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(exec_fds[0]);
+    execvp(args[0], args.data());
+    int exec_errno = errno;
+    (void)!write(exec_fds[1], &exec_errno, sizeof(exec_errno));
+    _exit(127);
+  }
+
+  // Also set from the parent, a kill right after the fork must not miss the group.
+  setpgid(pid, pid);
+  close(pipe_fds[1]);
+  close(exec_fds[1]);
+
+  int     exec_errno = 0;
+  ssize_t size       = read(exec_fds[0], &exec_errno, sizeof(exec_errno));
+  close(exec_fds[0]);
+  if (size == sizeof(exec_errno)) {
+    *error = "exec " + argv[0] + ": " + strerror(exec_errno);
+    close(pipe_fds[0]);
+    waitpid(pid, nullptr, 0);
+    return false;
+  }
+
+  fcntl(pipe_fds[0], F_SETFL, fcntl(pipe_fds[0], F_GETFL) | O_NONBLOCK);
+  process->pid    = pid;
+  process->fd     = pipe_fds[0];
+  process->exited = false;
+  process->status = 0;
+  return true;
+}
+
+void process_kill(const Process& process, int signal) {
+  if (process.pid > 0) kill(-process.pid, signal);
+}
+
+bool process_check_exit(Process* process) {
+  if (!process->exited && waitpid(process->pid, &process->status, WNOHANG) == process->pid) process->exited = true;
+  return process->exited;
+}
+
+ssize_t process_read(Process* process, char* buf, size_t size) {
+  if (process->fd < 0) return 0;
+  ssize_t result = read(process->fd, buf, size);
+  if (result < 0 && (errno == EAGAIN || errno == EINTR)) return -1;
+  if (result <= 0) {
+    close(process->fd);
+    process->fd = -1;
+    return 0;
+  }
+  return result;
+}
+
+int process_exit_code(const Process& process) {
+  if (WIFEXITED(process.status)) return WEXITSTATUS(process.status);
+  if (WIFSIGNALED(process.status)) return 128 + WTERMSIG(process.status);
+  return -1;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// One emulator process. stdout and stderr share a pipe, so the log keeps the order the emulator wrote in.
+struct Process {
+  pid_t pid    = -1;
+  int   fd     = -1; // Read end of the output pipe, -1 once it is closed
+  bool  exited = false;
+  int   status = 0; // waitpid status, valid once exited
+};
+
+// Starts argv[0] from PATH in a process group of its own, so a timeout can kill everything the emulator started.
+// Returns false and sets error if the process could not be started.
+bool process_start(const std::vector<std::string>& argv, Process* process, std::string* error);
+
+// Sends signal to the process group.
+void process_kill(const Process& process, int signal);
+
+// Checks for exit without blocking, returns process->exited.
+bool process_check_exit(Process* process);
+
+// Reads what is available without blocking. Returns the number of bytes, 0 on EOF (the pipe is closed then),
+// -1 when nothing is available right now.
+ssize_t process_read(Process* process, char* buf, size_t size);
+
+// Exit code or 128 + signal number, like a shell reports it.
+int process_exit_code(const Process& process);
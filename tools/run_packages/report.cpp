@@ -0,0 +1,110 @@
+#include "report.h"
+
+#include <cstdint>
+#include <cstdio>
+
+const char* package_status_name(PackageStatus status) {
+  switch (status) {
+    case PackageStatus::Passed: return "passed";
+    case PackageStatus::Failed: return "failed";
+    case PackageStatus::Watchdog: return "watchdog";
+    case PackageStatus::Timeout: return "timeout";
+    case PackageStatus::Crashed: return "crashed";
+    case PackageStatus::Error: return "error";
+  }
+  return "unknown";
+}
+
+void report_print(const std::vector<PackageResult>& results, double seconds) {
+  size_t passed = 0;
+  printf("\n%-12s %-10s %-9s %6s %6s %8s %8s\n", "suite", "title", "status", "tests", "failed", "checks", "seconds");
+  for (const PackageResult& result: results) {
+    printf("%-12s %-10s %-9s %6d %6d %8d %8.1f\n", result.suite.c_str(), result.title.c_str(), package_status_name(result.status), result.summary.tests,
+           result.summary.failures, result.summary.checks, result.seconds);
+    passed += result.status == PackageStatus::Passed ? 1 : 0;
+  }
+
+  for (const PackageResult& result: results) {
+    if (result.status == PackageStatus::Passed) continue;
+    printf("\n%s (%s, exit code %d): %s\n", result.title.c_str(), package_status_name(result.status), result.exit_code, result.log.c_str());
+    if (!result.error.empty()) printf("  %s\n", result.error.c_str());
+    for (const std::string& failure: result.failures) {
+      printf("  %s\n", failure.c_str());
+    }
+    for (const std::string& line: result.watchdog) {
+      printf("  %s\n", line.c_str());
+    }
+  }
+  printf("\n%zu of %zu packages passed in %.1f seconds\n", passed, results.size(), seconds);
+}
+
+static void json_append_string(std::string& out, const std::string& str) {
+  out += '"';
+  for (char c: str) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (uint8_t(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out += escaped;
+        } else {
+          out += c;
+        }
+        break;
+    }
+  }
+  out += '"';
+}
+
+static void json_append_strings(std::string& out, const std::vector<std::string>& strings) {
+  out += '[';
+  for (size_t i = 0; i < strings.size(); ++i) {
+    if (i != 0) out += ',';
+    json_append_string(out, strings[i]);
+  }
+  out += ']';
+}
+
+bool report_write_json(const std::vector<PackageResult>& results, double seconds, const std::string& path) {
+  std::string json;
+  char        number[128];
+  size_t      passed = 0;
+
+  json += "{\"packages\":[";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const PackageResult& result = results[i];
+    passed += result.status == PackageStatus::Passed ? 1 : 0;
+
+    json += i == 0 ? "{\"suite\":" : ",{\"suite\":";
+    json_append_string(json, result.suite);
+    json += ",\"title_id\":";
+    json_append_string(json, result.title);
+    json += ",\"status\":";
+    json_append_string(json, package_status_name(result.status));
+    snprintf(number, sizeof(number),
+             ",\"exit_code\":%d,\"seconds\":%.3f,\"tests\":%d,\"ran\":%d,\"failures\":%d,\"checks\":%d,\"ignored\":%d,\"filtered_out\":%d", result.exit_code,
+             result.seconds, result.summary.tests, result.summary.ran, result.summary.failures, result.summary.checks, result.summary.ignored,
+             result.summary.filtered_out);
+    json += number;
+    json += ",\"log\":";
+    json_append_string(json, result.log);
+    json += ",\"error\":";
+    json_append_string(json, result.error);
+    json += ",\"failed_tests\":";
+    json_append_strings(json, result.failures);
+    json += ",\"watchdog\":";
+    json_append_strings(json, result.watchdog);
+    json += '}';
+  }
+  snprintf(number, sizeof(number), "],\"passed\":%zu,\"total\":%zu,\"seconds\":%.3f}\n", passed, results.size(), seconds);
+  json += number;
+
+  FILE* file = fopen(path.c_str(), "wb");
+  if (file == nullptr) return false;
+  bool ok = fwrite(json.data(), 1, json.size(), file) == json.size();
+  return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "cpputest_log.h"
+
+#include <string>
+#include <vector>
+
+enum class PackageStatus {
+  Passed,   // CppUTest summary without failures
+  Failed,   // CppUTest summary with failures
+  Watchdog, // The runner's watchdog ended the package, see tests/common/watchdog.h
+  Timeout,  // Killed after --timeout
+  Crashed,  // Exited without a CppUTest summary
+  Error,    // The emulator could not be started
+};
+
+struct PackageResult {
+  std::string              suite; // Folder below the install dir, memory_test, template, ...
+  std::string              title; // Title ID, also the package folder name
+  std::string              dir;
+  std::string              log;
+  PackageStatus            status    = PackageStatus::Error;
+  int                      exit_code = -1;
+  double                   seconds   = 0;
+  std::string              error;
+  TestSummary              summary;
+  std::vector<std::string> failures;
+  std::vector<std::string> watchdog;
+};
+
+const char* package_status_name(PackageStatus status);
+
+// Table with one line per package and the failed tests below it.
+void report_print(const std::vector<PackageResult>& results, double seconds);
+
+// Same content as JSON, for CI dashboards. Returns false if the file can't be written.
+bool report_write_json(const std::vector<PackageResult>& results, double seconds, const std::string& path);